@@ -0,0 +1,247 @@
+/**
+ * Taiga
+ * Copyright (C) 2010-2025, Eren Okka
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// Usage: bench-anilist-sync [options]
+//
+// Imports lists of 100, 1,000 and 10,000 entries from a local mock of the
+// AniList API, both as a whole collection and page by page, and reports the
+// time, the requests issued and the peak memory usage of each.
+//
+// With `--serve`, only the mock server is started, so that the application can
+// be pointed at it through the `sync.anilist.apiUrl` setting.
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QNetworkRequest>
+#include <QThread>
+#include <memory>
+#include <optional>
+#include <print>
+
+#ifdef Q_OS_WINDOWS
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+#include "mock_anilist_server.hpp"
+#include "sync/anilist_parsers.hpp"
+
+using namespace Qt::Literals::StringLiterals;
+
+namespace {
+
+constexpr int kMaxPerPage = 50;
+constexpr int kListSizes[]{100, 1'000, 10'000};
+
+// Only the fields that the mock server looks for matter
+constexpr auto kMediaListCollection =
+    "query ($userName: String!) { MediaListCollection (userName: $userName, type: ANIME) { ... } }";
+constexpr auto kMediaListPage =
+    "query ($userName: String!, $page: Int, $perPage: Int) { Page (page: $page, perPage: "
+    "$perPage) { mediaList (userName: $userName, type: ANIME) { ... } } }";
+
+struct Result {
+  qint64 elapsed = 0;
+  qsizetype entries = 0;
+};
+
+qint64 peakMemoryUsage() {
+#ifdef Q_OS_WINDOWS
+  PROCESS_MEMORY_COUNTERS counters{};
+  if (!::GetProcessMemoryInfo(::GetCurrentProcess(), &counters, sizeof(counters))) return 0;
+  return static_cast<qint64>(counters.PeakWorkingSetSize);
+#else
+  rusage usage{};
+  if (::getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+#ifdef Q_OS_MACOS
+  return usage.ru_maxrss;
+#else
+  return qint64{usage.ru_maxrss} * 1024;
+#endif
+#endif
+}
+
+QNetworkReply* post(QNetworkAccessManager& manager, const QUrl& url, const char* query,
+                    const QJsonObject& variables) {
+  QNetworkRequest request{url};
+  request.setHeader(QNetworkRequest::ContentTypeHeader, "application/json");
+  const QJsonDocument data{QJsonObject{
+      {"query", QString::fromLatin1(query)},
+      {"variables", variables},
+  }};
+  return manager.post(request, data.toJson(QJsonDocument::Compact));
+}
+
+void waitForFinished(QNetworkReply* reply) {
+  QEventLoop loop;
+  QObject::connect(reply, &QNetworkReply::finished, &loop, &QEventLoop::quit);
+  if (!reply->isFinished()) loop.exec();
+}
+
+// Requests beyond the rate limit are sent again after the time the server asks
+// for, as the request scheduler does.
+bool waitForRetry(QNetworkReply* reply) {
+  if (reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() != 429) return false;
+  const auto seconds = reply->rawHeader("Retry-After").toInt();
+  QThread::sleep(std::chrono::seconds{std::max(seconds, 1)});
+  return true;
+}
+
+// Entries are decoded while the response arrives, as `fetchListCollection` does
+std::optional<Result> importCollection(QNetworkAccessManager& manager, const QUrl& url) {
+  QElapsedTimer timer;
+  timer.start();
+
+  while (true) {
+    sync::anilist::MediaListCollectionReader reader;
+
+    const std::unique_ptr<QNetworkReply> reply{
+        post(manager, url, kMediaListCollection, {{"userName", "bench"}})};
+    QObject::connect(reply.get(), &QNetworkReply::readyRead, reply.get(), [&reply, &reader]() {
+      if (reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() == 200) {
+        reader.read(reply->readAll());
+      }
+    });
+    waitForFinished(reply.get());
+
+    if (waitForRetry(reply.get())) continue;
+    if (reply->error() != QNetworkReply::NoError) return std::nullopt;
+
+    reader.read(reply->readAll());
+    const auto collection = reader.result();
+    if (!collection) return std::nullopt;
+
+    return Result{.elapsed = timer.elapsed(), .entries = collection->entries.size()};
+  }
+}
+
+// Pages are decoded as a whole, as `fetchListPage` does
+std::optional<Result> importPages(QNetworkAccessManager& manager, const QUrl& url) {
+  QElapsedTimer timer;
+  timer.start();
+
+  sync::anilist::MediaListCollection collection;
+
+  for (int page = 1;;) {
+    const std::unique_ptr<QNetworkReply> reply{
+        post(manager, url, kMediaListPage,
+             {{"userName", "bench"}, {"page", page}, {"perPage", kMaxPerPage}})};
+    waitForFinished(reply.get());
+
+    if (waitForRetry(reply.get())) continue;
+    if (reply->error() != QNetworkReply::NoError) return std::nullopt;
+
+    const auto json = QJsonDocument::fromJson(reply->readAll());
+    const auto value = json["data"]["Page"];
+    if (!value["mediaList"].isArray()) return std::nullopt;
+
+    for (const auto object : value["mediaList"].toArray()) {
+      auto entry = sync::anilist::parseMediaList(object);
+      if (!entry) continue;
+      if (auto item = sync::anilist::parseMedia(object["media"])) {
+        collection.items.push_back(std::move(*item));
+      }
+      collection.entries.push_back(std::move(*entry));
+    }
+
+    if (!value["pageInfo"]["hasNextPage"].toBool()) break;
+    ++page;
+  }
+
+  return Result{.elapsed = timer.elapsed(), .entries = collection.entries.size()};
+}
+
+void report(const char* name, const bench::MockAniListServer& server,
+            const std::optional<Result>& result) {
+  if (!result) {
+    std::println("{:<12} failed", name);
+    return;
+  }
+  std::println("{:<12} {:>8} ms {:>7} entries {:>5} requests {:>10} KiB sent {:>8} KiB peak",
+               name, result->elapsed, result->entries, server.requestCount(),
+               server.bytesSent() / 1024, peakMemoryUsage() / 1024);
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  QCoreApplication app{argc, argv};
+
+  QCommandLineParser parser;
+  parser.addHelpOption();
+  parser.addOptions({
+      {"serve", "Only start the mock server."},
+      {"port", "Port of the mock server.", "port", "0"},
+      {"entries", "Size of the list, instead of each of the default sizes.", "count"},
+      {"description-length", "Length of each media description.", "length", "500"},
+      {"latency", "Delay before each response, in milliseconds.", "ms", "0"},
+      {"rate-limit", "Requests per minute, or 0 for no limit.", "count", "0"},
+      {"recordings", "Directory of recorded responses, named after the query.", "path"},
+  });
+  parser.process(app);
+
+  bench::MockAniListServer::Options options{
+      .description_length = parser.value("description-length").toInt(),
+      .rate_limit = parser.value("rate-limit").toInt(),
+      .latency = std::chrono::milliseconds{parser.value("latency").toInt()},
+      .recordings = parser.value("recordings"),
+  };
+
+  if (parser.isSet("serve")) {
+    options.entries = parser.isSet("entries") ? parser.value("entries").toInt() : kListSizes[0];
+    bench::MockAniListServer server{options};
+    if (!server.listen(parser.value("port").toUShort())) return 1;
+    std::println("Serving a list of {} entries at {}", options.entries,
+                 server.url().toString().toStdString());
+    return app.exec();
+  }
+
+  QList<int> sizes{std::begin(kListSizes), std::end(kListSizes)};
+  if (parser.isSet("entries")) sizes = {parser.value("entries").toInt()};
+
+  // Peak memory usage only grows, so lists are imported from the smallest up
+  for (const int size : sizes) {
+    std::println("{} entries:", size);
+    options.entries = size;
+
+    {
+      bench::MockAniListServer server{options};
+      if (!server.listen()) return 1;
+      QNetworkAccessManager manager;
+      report("Collection", server, importCollection(manager, server.url()));
+    }
+
+    {
+      bench::MockAniListServer server{options};
+      if (!server.listen()) return 1;
+      QNetworkAccessManager manager;
+      report("Pages", server, importPages(manager, server.url()));
+    }
+  }
+
+  return 0;
+}
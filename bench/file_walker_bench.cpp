@@ -0,0 +1,151 @@
+/**
+ * Taiga
+ * Copyright (C) 2010-2025, Eren Okka
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// Usage: bench-file-walker [root]
+//
+// Walks `root` with `QDirIterator`, `QtFileWalker` and the platform walker, with
+// and without file sizes and times. Without a root, a tree of 200,000 files is
+// created in a temporary directory first.
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QDirIterator>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QTemporaryDir>
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <print>
+#include <string>
+
+#include "track/file_walker.hpp"
+
+using namespace Qt::Literals::StringLiterals;
+
+namespace {
+
+constexpr int kFolderCount = 200;
+constexpr int kSubfolderCount = 10;
+constexpr int kFileCount = 100;  // per subfolder
+constexpr int kRunCount = 5;
+
+struct Result {
+  qint64 entries = 0;
+  qint64 bytes = 0;
+  qint64 last_modified = 0;
+};
+
+using run_t = std::function<Result()>;
+
+bool createTree(const QString& root) {
+  QDir dir{root};
+
+  for (int i = 0; i < kFolderCount; ++i) {
+    for (int j = 0; j < kSubfolderCount; ++j) {
+      const auto path = u"Series %1/Season %2"_s.arg(i).arg(j);
+      if (!dir.mkpath(path)) return false;
+      for (int k = 0; k < kFileCount; ++k) {
+        QFile file{u"%1/%2/[Group] Series %3 - %4 [1080p].mkv"_s.arg(root, path).arg(i).arg(k)};
+        if (!file.open(QIODevice::WriteOnly)) return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+Result walkDirIterator(const QString& root, const bool stat) {
+  Result result;
+
+  QDirIterator it{root, QDir::Dirs | QDir::Files | QDir::NoDotAndDotDot,
+                  QDirIterator::Subdirectories};
+
+  while (it.hasNext()) {
+    const auto info = it.nextFileInfo();
+    ++result.entries;
+    if (stat) {
+      result.bytes += info.size();
+      result.last_modified =
+          std::max(result.last_modified, info.lastModified().toSecsSinceEpoch());
+    }
+  }
+
+  return result;
+}
+
+Result walkFileWalker(track::FileWalker& walker, const std::string& root, const bool stat) {
+  Result result;
+
+  walker.walk(root, {.recursive = true, .stat = stat}, [&](const track::FileEntry& entry) {
+    ++result.entries;
+    result.bytes += entry.size;
+    result.last_modified = std::max(result.last_modified, entry.last_modified);
+    return track::WalkResult::Continue;
+  });
+
+  return result;
+}
+
+// Reports the fastest of several runs, after the first run has warmed up the
+// file system cache.
+void measure(const char* name, const run_t& run) {
+  Result result = run();
+  qint64 best = std::numeric_limits<qint64>::max();
+
+  for (int i = 0; i < kRunCount; ++i) {
+    QElapsedTimer timer;
+    timer.start();
+    result = run();
+    best = std::min(best, timer.elapsed());
+  }
+
+  std::println("{:<28} {:>8} ms {:>10} entries", name, best, result.entries);
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  QCoreApplication app{argc, argv};
+
+  QTemporaryDir temporaryDir;
+  QString root;
+
+  if (argc > 1) {
+    root = QDir::cleanPath(QString::fromLocal8Bit(argv[1]));
+  } else {
+    if (!temporaryDir.isValid()) return 1;
+    root = temporaryDir.path();
+    std::println("Creating {} files in {}...", kFolderCount * kSubfolderCount * kFileCount,
+                 root.toStdString());
+    if (!createTree(root)) return 1;
+  }
+
+  const auto path = root.toStdString();
+  track::QtFileWalker qtWalker;
+  const auto platformWalker = track::createFileWalker();
+
+  for (const bool stat : {false, true}) {
+    std::println("{}", stat ? "With sizes and times:" : "Names only:");
+    measure("QDirIterator", [&]() { return walkDirIterator(root, stat); });
+    measure("QtFileWalker", [&]() { return walkFileWalker(qtWalker, path, stat); });
+    measure("createFileWalker()", [&]() { return walkFileWalker(*platformWalker, path, stat); });
+  }
+
+  return 0;
+}
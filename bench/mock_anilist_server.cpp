@@ -0,0 +1,363 @@
+/**
+ * Taiga
+ * Copyright (C) 2010-2025, Eren Okka
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "mock_anilist_server.hpp"
+
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QTcpSocket>
+#include <QTimer>
+#include <algorithm>
+#include <iterator>
+
+using namespace Qt::Literals::StringLiterals;
+
+namespace bench {
+
+namespace {
+
+constexpr auto kRateLimitWindow = std::chrono::seconds{60};
+constexpr qint64 kUpdatedAt = 1'700'000'000;
+
+QByteArray reasonPhrase(const int status) {
+  switch (status) {
+    case 200:
+      return "OK";
+    case 400:
+      return "Bad Request";
+    case 429:
+      return "Too Many Requests";
+    default:
+      return "Error";
+  }
+}
+
+QJsonObject fuzzyDate(const int year, const int month, const int day) {
+  return {{"year", year}, {"month", month}, {"day", day}};
+}
+
+QJsonObject errorResponse(const QString& message) {
+  return {{"data", QJsonValue::Null}, {"errors", QJsonArray{QJsonObject{{"message", message}}}}};
+}
+
+}  // namespace
+
+QString operationName(const QString& query) {
+  // clang-format off
+  static const std::pair<QString, QString> table[]{
+      {u"DeleteMediaListEntry"_s, u"DeleteMediaListEntry"_s},
+      {u"SaveMediaListEntry"_s,   u"SaveMediaListEntries"_s},
+      {u"MediaListCollection"_s,  u"MediaListCollection"_s},
+      {u"mediaList"_s,            u"MediaListPage"_s},
+      {u"search:"_s,              u"MediaSearch"_s},
+      {u"id_in:"_s,               u"MediaPage"_s},
+      {u"Viewer"_s,               u"Viewer"_s},
+  };
+  // clang-format on
+
+  for (const auto& [field, name] : table) {
+    if (query.contains(field)) return name;
+  }
+
+  return {};
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+MockAniListServer::MockAniListServer(const Options& options) : options_{options} {
+  QObject::connect(&server_, &QTcpServer::pendingConnectionAvailable, &server_, [this]() {
+    while (const auto socket = server_.nextPendingConnection()) {
+      QObject::connect(socket, &QTcpSocket::readyRead, &server_,
+                       [this, socket]() { readRequests(socket); });
+      QObject::connect(socket, &QTcpSocket::disconnected, &server_, [this, socket]() {
+        buffers_.remove(socket);
+        socket->deleteLater();
+      });
+    }
+  });
+}
+
+// The largest response is generated up front, so that it does not count towards
+// the time of the first request
+bool MockAniListServer::listen(const quint16 port) {
+  if (recordedResponse(u"MediaListCollection"_s).isNull()) {
+    list_collection_ = QJsonDocument{generateResponse(u"MediaListCollection"_s, {})}.toJson(
+        QJsonDocument::Compact);
+  }
+  return server_.listen(QHostAddress::LocalHost, port);
+}
+
+QUrl MockAniListServer::url() const {
+  return QUrl{u"http://127.0.0.1:%1/"_s.arg(server_.serverPort())};
+}
+
+int MockAniListServer::requestCount() const {
+  return request_count_;
+}
+
+qint64 MockAniListServer::bytesSent() const {
+  return bytes_sent_;
+}
+
+// Connections are kept alive, so a buffer may hold several requests, or only
+// a part of one.
+void MockAniListServer::readRequests(QTcpSocket* socket) {
+  auto& buffer = buffers_[socket];
+  buffer.append(socket->readAll());
+
+  while (true) {
+    const auto headerEnd = buffer.indexOf("\r\n\r\n");
+    if (headerEnd < 0) return;
+
+    qsizetype contentLength = 0;
+    for (const auto& line : buffer.left(headerEnd).split('\n')) {
+      const auto pos = line.indexOf(':');
+      if (pos < 0) continue;
+      if (line.left(pos).trimmed().compare("content-length", Qt::CaseInsensitive) == 0) {
+        contentLength = line.mid(pos + 1).trimmed().toLongLong();
+      }
+    }
+
+    const auto requestSize = headerEnd + 4 + contentLength;
+    if (buffer.size() < requestSize) return;
+
+    const auto response = handleRequest(buffer.mid(headerEnd + 4, contentLength));
+    buffer.remove(0, requestSize);
+
+    QByteArray data = "HTTP/1.1 " + QByteArray::number(response.status) + ' ' +
+                      reasonPhrase(response.status) + "\r\n";
+    data += "Content-Type: application/json\r\n";
+    data += "Content-Length: " + QByteArray::number(response.body.size()) + "\r\n";
+    for (const auto& [name, value] : response.headers) {
+      data += name + ": " + value + "\r\n";
+    }
+    data += "\r\n";
+    data += response.body;
+
+    bytes_sent_ += data.size();
+
+    QTimer::singleShot(options_.latency, socket, [socket, data]() { socket->write(data); });
+  }
+}
+
+MockAniListServer::Response MockAniListServer::handleRequest(const QByteArray& body) {
+  ++request_count_;
+
+  Response response;
+
+  if (!acquire(response)) {
+    response.body = QJsonDocument{errorResponse(u"Too Many Requests."_s)}.toJson();
+    return response;
+  }
+
+  const auto json = QJsonDocument::fromJson(body).object();
+  const auto operation = operationName(json["query"].toString());
+
+  if (operation.isEmpty()) {
+    response.status = 400;
+    response.body = QJsonDocument{errorResponse(u"Unknown query."_s)}.toJson();
+    return response;
+  }
+
+  if (auto recorded = recordedResponse(operation); !recorded.isNull()) {
+    response.body = std::move(recorded);
+    return response;
+  }
+
+  if (operation == u"MediaListCollection"_s) {
+    response.body = list_collection_;
+    return response;
+  }
+
+  response.body = QJsonDocument{generateResponse(operation, json["variables"].toObject())}.toJson(
+      QJsonDocument::Compact);
+  return response;
+}
+
+// Requests are counted within a sliding window of a minute
+bool MockAniListServer::acquire(Response& response) {
+  if (options_.rate_limit < 1) return true;
+
+  const auto now = std::chrono::steady_clock::now();
+  while (!requests_.empty() && now - requests_.front() >= kRateLimitWindow) {
+    requests_.pop_front();
+  }
+
+  const auto limit = QByteArray::number(options_.rate_limit);
+
+  if (std::ssize(requests_) >= options_.rate_limit) {
+    const auto wait = std::chrono::ceil<std::chrono::seconds>(requests_.front() +
+                                                              kRateLimitWindow - now);
+    response.status = 429;
+    response.headers = {
+        {"Retry-After", QByteArray::number(std::max<qint64>(wait.count(), 1))},
+        {"X-RateLimit-Limit", limit},
+        {"X-RateLimit-Remaining", "0"},
+    };
+    return false;
+  }
+
+  requests_.push_back(now);
+  response.headers = {
+      {"X-RateLimit-Limit", limit},
+      {"X-RateLimit-Remaining", QByteArray::number(options_.rate_limit - std::ssize(requests_))},
+  };
+  return true;
+}
+
+QByteArray MockAniListServer::recordedResponse(const QString& operation) {
+  if (options_.recordings.isEmpty()) return {};
+
+  if (const auto it = recordings_.constFind(operation); it != recordings_.cend()) return *it;
+
+  QFile file{u"%1/%2.json"_s.arg(options_.recordings, operation)};
+  const auto data = file.open(QIODevice::ReadOnly) ? file.readAll() : QByteArray{};
+  recordings_.insert(operation, data);
+  return data;
+}
+
+QJsonObject MockAniListServer::generateResponse(const QString& operation,
+                                                const QJsonObject& variables) const {
+  if (operation == u"Viewer"_s) {
+    return {{"data", QJsonObject{{"Viewer", QJsonObject{
+                                                {"id", 1},
+                                                {"name", "bench"},
+                                                {"mediaListOptions",
+                                                 QJsonObject{{"scoreFormat", "POINT_100"}}},
+                                            }}}}};
+  }
+
+  if (operation == u"MediaPage"_s) {
+    QJsonArray media;
+    for (const auto id : variables["ids"].toArray()) {
+      media.append(generateMedia(id.toInt()));
+    }
+    return {{"data", QJsonObject{{"Page", QJsonObject{{"media", media}}}}}};
+  }
+
+  if (operation == u"MediaSearch"_s) {
+    const int perPage = std::max(variables["perPage"].toInt(), 1);
+    const int page = std::max(variables["page"].toInt(), 1);
+    const int lastPage = std::max((options_.entries + perPage - 1) / perPage, 1);
+    QJsonArray media;
+    for (int id = (page - 1) * perPage + 1; id <= std::min(page * perPage, options_.entries);
+         ++id) {
+      media.append(generateMedia(id));
+    }
+    return {{"data", QJsonObject{{"Page", QJsonObject{
+                                              {"media", media},
+                                              {"pageInfo", QJsonObject{
+                                                               {"total", options_.entries},
+                                                               {"perPage", perPage},
+                                                               {"currentPage", page},
+                                                               {"lastPage", lastPage},
+                                                               {"hasNextPage", page < lastPage},
+                                                           }},
+                                          }}}}};
+  }
+
+  if (operation == u"MediaListCollection"_s) {
+    QJsonArray entries;
+    for (int id = 1; id <= options_.entries; ++id) {
+      entries.append(generateEntry(id));
+    }
+    return {{"data",
+             QJsonObject{{"MediaListCollection",
+                          QJsonObject{{"lists", QJsonArray{QJsonObject{{"entries", entries}}}}}}}}};
+  }
+
+  // Entries are sorted by the time they were updated, most recent first
+  if (operation == u"MediaListPage"_s) {
+    const int perPage = std::max(variables["perPage"].toInt(), 1);
+    const int page = std::max(variables["page"].toInt(), 1);
+    QJsonArray entries;
+    for (int i = (page - 1) * perPage; i < std::min(page * perPage, options_.entries); ++i) {
+      entries.append(generateEntry(options_.entries - i));
+    }
+    return {{"data", QJsonObject{{"Page", QJsonObject{
+                                              {"pageInfo", QJsonObject{{"hasNextPage",
+                                                                        page * perPage <
+                                                                            options_.entries}}},
+                                              {"mediaList", entries},
+                                          }}}}};
+  }
+
+  return errorResponse(u"%1 is not supported."_s.arg(operation));
+}
+
+QJsonObject MockAniListServer::generateMedia(const int id) const {
+  static const auto kLorem =
+      u"Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod tempor "_s;
+
+  QString description;
+  description.reserve(options_.description_length);
+  while (description.size() < options_.description_length) description += kLorem;
+  description.truncate(options_.description_length);
+
+  const int year = 1990 + id % 35;
+
+  return {
+      {"id", id},
+      {"idMal", id},
+      {"title", QJsonObject{
+                    {"romaji", u"Series %1"_s.arg(id)},
+                    {"english", u"The Series %1"_s.arg(id)},
+                    {"native", u"シリーズ%1"_s.arg(id)},
+                }},
+      {"format", "TV"},
+      {"status", "FINISHED"},
+      {"description", description},
+      {"startDate", fuzzyDate(year, 1 + id % 12, 1 + id % 28)},
+      {"endDate", fuzzyDate(year, 1 + (id + 3) % 12, 1 + id % 28)},
+      {"episodes", 12 + id % 14},
+      {"duration", 24},
+      {"countryOfOrigin", "JP"},
+      {"trailer", QJsonValue::Null},
+      {"updatedAt", kUpdatedAt},
+      {"coverImage",
+       QJsonObject{{"extraLarge", u"https://example.invalid/cover/%1.jpg"_s.arg(id)}}},
+      {"genres", QJsonArray{"Action", "Drama", "Fantasy"}},
+      {"synonyms", QJsonArray{u"S%1"_s.arg(id)}},
+      {"averageScore", 50 + id % 40},
+      {"popularity", 100'000 - id},
+      {"tags", QJsonArray{QJsonObject{{"name", "Ensemble Cast"}, {"isMediaSpoiler", false}}}},
+      {"studios",
+       QJsonObject{{"edges", QJsonArray{QJsonObject{{"isMain", true},
+                                                    {"node", QJsonObject{{"name", "Studio"}}}}}}}},
+      {"nextAiringEpisode", QJsonValue::Null},
+  };
+}
+
+QJsonObject MockAniListServer::generateEntry(const int id) const {
+  return {
+      {"id", 1'000'000 + id},
+      {"status", id % 5 ? "COMPLETED" : "CURRENT"},
+      {"score", id % 101},
+      {"progress", 12 + id % 14},
+      {"repeat", 0},
+      {"private", false},
+      {"notes", ""},
+      {"startedAt", fuzzyDate(2020, 1 + id % 12, 1 + id % 28)},
+      {"completedAt", fuzzyDate(2021, 1 + id % 12, 1 + id % 28)},
+      {"updatedAt", kUpdatedAt + id},
+      {"media", generateMedia(id)},
+  };
+}
+
+}  // namespace bench
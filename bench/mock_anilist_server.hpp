@@ -0,0 +1,88 @@
+/**
+ * Taiga
+ * Copyright (C) 2010-2025, Eren Okka
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QByteArray>
+#include <QHash>
+#include <QJsonObject>
+#include <QString>
+#include <QTcpServer>
+#include <QUrl>
+#include <chrono>
+#include <deque>
+
+class QTcpSocket;
+
+namespace bench {
+
+// Answers the GraphQL queries of the AniList service over plain HTTP, so that
+// sync can be measured without the real API. Responses are generated for a
+// list of the given size, unless a recorded response named after the query
+// (e.g. `MediaListCollection.json`) is found in the recordings directory.
+//
+// Requests beyond the rate limit are answered with 429, along with the same
+// headers that the real API sends.
+class MockAniListServer final {
+public:
+  struct Options {
+    int entries = 100;
+    int description_length = 500;  // controls the size of each media object
+    int rate_limit = 0;            // requests per minute, or 0 for no limit
+    std::chrono::milliseconds latency{0};
+    QString recordings;
+  };
+
+  explicit MockAniListServer(const Options& options);
+
+  bool listen(const quint16 port = 0);
+  QUrl url() const;
+
+  int requestCount() const;
+  qint64 bytesSent() const;
+
+private:
+  struct Response {
+    int status = 200;
+    QByteArray body;
+    QList<std::pair<QByteArray, QByteArray>> headers;
+  };
+
+  void readRequests(QTcpSocket* socket);
+  Response handleRequest(const QByteArray& body);
+  bool acquire(Response& response);
+
+  QByteArray recordedResponse(const QString& operation);
+  QJsonObject generateResponse(const QString& operation, const QJsonObject& variables) const;
+  QJsonObject generateMedia(const int id) const;
+  QJsonObject generateEntry(const int id) const;
+
+  Options options_;
+  QTcpServer server_;
+  QHash<QTcpSocket*, QByteArray> buffers_;
+  QHash<QString, QByteArray> recordings_;
+  QByteArray list_collection_;
+  std::deque<std::chrono::steady_clock::time_point> requests_;
+  int request_count_ = 0;
+  qint64 bytes_sent_ = 0;
+};
+
+// Tells which query a request is for, by the fields that it selects
+QString operationName(const QString& query);
+
+}  // namespace bench
@@ -0,0 +1,203 @@
+/**
+ * Taiga
+ * Copyright (C) 2010-2025, Eren Okka
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "crc32.hpp"
+
+#include <array>
+#include <bit>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define TAIGA_CRC32_CLMUL
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#include <immintrin.h>
+#endif
+
+namespace {
+
+constexpr std::uint32_t kPolynomial = 0xEDB88320;  // reflected 0x04C11DB7
+
+using table_t = std::array<std::array<std::uint32_t, 256>, 8>;
+
+// Tables for slicing-by-8, which processes eight bytes per iteration
+constexpr table_t makeTables() {
+  table_t tables{};
+  for (std::uint32_t i = 0; i < 256; ++i) {
+    std::uint32_t crc = i;
+    for (int j = 0; j < 8; ++j) {
+      crc = (crc >> 1) ^ (kPolynomial & (0 - (crc & 1)));
+    }
+    tables[0][i] = crc;
+  }
+  for (std::uint32_t i = 0; i < 256; ++i) {
+    for (size_t t = 1; t < tables.size(); ++t) {
+      tables[t][i] = (tables[t - 1][i] >> 8) ^ tables[0][tables[t - 1][i] & 0xFF];
+    }
+  }
+  return tables;
+}
+
+constexpr table_t kTables = makeTables();
+
+std::uint32_t crc32Table(const std::byte* data, size_t size, std::uint32_t crc) {
+  while (size >= 8) {
+    std::uint32_t lo;
+    std::uint32_t hi;
+    std::memcpy(&lo, data, 4);
+    std::memcpy(&hi, data + 4, 4);
+    if constexpr (std::endian::native == std::endian::big) {
+      lo = std::byteswap(lo);
+      hi = std::byteswap(hi);
+    }
+    lo ^= crc;
+    crc = kTables[7][lo & 0xFF] ^ kTables[6][(lo >> 8) & 0xFF] ^ kTables[5][(lo >> 16) & 0xFF] ^
+          kTables[4][lo >> 24] ^ kTables[3][hi & 0xFF] ^ kTables[2][(hi >> 8) & 0xFF] ^
+          kTables[1][(hi >> 16) & 0xFF] ^ kTables[0][hi >> 24];
+    data += 8;
+    size -= 8;
+  }
+
+  while (size--) {
+    crc = (crc >> 8) ^ kTables[0][(crc ^ static_cast<std::uint8_t>(*data++)) & 0xFF];
+  }
+
+  return crc;
+}
+
+#ifdef TAIGA_CRC32_CLMUL
+
+constexpr size_t kClmulMinimumSize = 64;
+
+bool isClmulSupported() {
+#ifdef _MSC_VER
+  int info[4]{};
+  __cpuid(info, 1);
+  const bool pclmul = info[2] & (1 << 1);
+  const bool sse41 = info[2] & (1 << 19);
+  return pclmul && sse41;
+#else
+  return __builtin_cpu_supports("pclmul") && __builtin_cpu_supports("sse4.1");
+#endif
+}
+
+#ifdef _MSC_VER
+#define TAIGA_TARGET_CLMUL
+#else
+#define TAIGA_TARGET_CLMUL __attribute__((target("pclmul,sse4.1")))
+#endif
+
+TAIGA_TARGET_CLMUL inline __m128i load(const std::byte* p) {
+  return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+}
+
+TAIGA_TARGET_CLMUL inline __m128i fold(const __m128i x, const __m128i k, const __m128i y) {
+  const auto lo = _mm_clmulepi64_si128(x, k, 0x00);
+  const auto hi = _mm_clmulepi64_si128(x, k, 0x11);
+  return _mm_xor_si128(_mm_xor_si128(hi, lo), y);
+}
+
+// Folds 64 bytes per iteration with carry-less multiplication, then reduces
+// the result with Barrett reduction. The constants are from Intel's paper "Fast
+// CRC Computation for Generic Polynomials Using PCLMULQDQ Instruction".
+// Requires `size` to be at least 64 and a multiple of 16.
+TAIGA_TARGET_CLMUL std::uint32_t crc32Clmul(const std::byte* data, size_t size,
+                                            std::uint32_t crc) {
+  alignas(16) static constexpr std::uint64_t k1k2[] = {0x0154442bd4, 0x01c6e41596};
+  alignas(16) static constexpr std::uint64_t k3k4[] = {0x01751997d0, 0x00ccaa009e};
+  alignas(16) static constexpr std::uint64_t k5k0[] = {0x0163cd6124, 0x0000000000};
+  alignas(16) static constexpr std::uint64_t poly[] = {0x01db710641, 0x01f7011641};
+
+  auto x1 = _mm_xor_si128(load(data + 0x00), _mm_cvtsi32_si128(static_cast<int>(crc)));
+  auto x2 = load(data + 0x10);
+  auto x3 = load(data + 0x20);
+  auto x4 = load(data + 0x30);
+  data += 64;
+  size -= 64;
+
+  // Fold four blocks in parallel
+  auto k = _mm_load_si128(reinterpret_cast<const __m128i*>(k1k2));
+  while (size >= 64) {
+    x1 = fold(x1, k, load(data + 0x00));
+    x2 = fold(x2, k, load(data + 0x10));
+    x3 = fold(x3, k, load(data + 0x20));
+    x4 = fold(x4, k, load(data + 0x30));
+    data += 64;
+    size -= 64;
+  }
+
+  // Fold into 128 bits
+  k = _mm_load_si128(reinterpret_cast<const __m128i*>(k3k4));
+  x1 = fold(x1, k, x2);
+  x1 = fold(x1, k, x3);
+  x1 = fold(x1, k, x4);
+
+  // Fold the remaining 16-byte blocks
+  while (size >= 16) {
+    x1 = fold(x1, k, load(data));
+    data += 16;
+    size -= 16;
+  }
+
+  // Fold 128 bits into 64 bits
+  const auto mask = _mm_setr_epi32(~0, 0, ~0, 0);
+  x2 = _mm_clmulepi64_si128(x1, k, 0x10);
+  x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), x2);
+  k = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(k5k0));
+  x2 = _mm_srli_si128(x1, 4);
+  x1 = _mm_and_si128(x1, mask);
+  x1 = _mm_xor_si128(_mm_clmulepi64_si128(x1, k, 0x00), x2);
+
+  // Barrett reduction to 32 bits
+  k = _mm_load_si128(reinterpret_cast<const __m128i*>(poly));
+  x2 = _mm_and_si128(x1, mask);
+  x2 = _mm_clmulepi64_si128(x2, k, 0x10);
+  x2 = _mm_and_si128(x2, mask);
+  x2 = _mm_clmulepi64_si128(x2, k, 0x00);
+  x1 = _mm_xor_si128(x1, x2);
+
+  return static_cast<std::uint32_t>(_mm_extract_epi32(x1, 1));
+}
+
+#endif  // TAIGA_CRC32_CLMUL
+
+}  // namespace
+
+namespace base {
+
+std::uint32_t crc32(std::span<const std::byte> data, std::uint32_t crc) {
+  auto p = data.data();
+  auto size = data.size();
+
+  crc = ~crc;
+
+#ifdef TAIGA_CRC32_CLMUL
+  static const bool is_clmul_supported = isClmulSupported();
+  if (is_clmul_supported && size >= kClmulMinimumSize) {
+    const auto chunk_size = size & ~size_t{15};
+    crc = crc32Clmul(p, chunk_size, crc);
+    p += chunk_size;
+    size -= chunk_size;
+  }
+#endif
+
+  return ~crc32Table(p, size, crc);
+}
+
+}  // namespace base
@@ -19,6 +19,9 @@
 #include "file.hpp"
 
 #include <QFile>
+#include <memory>
+
+#include "base/crc32.hpp"
 
 namespace base {
 
@@ -27,4 +30,25 @@ QString readFile(const QString& name) {
   return file.open(QFile::ReadOnly) ? file.readAll() : QString{};
 }
 
+std::optional<std::uint32_t> crc32File(const QString& name) {
+  // Large unbuffered reads keep the number of system calls low, which matters
+  // most for files on network shares.
+  constexpr qint64 kBufferSize = 4 * 1024 * 1024;
+
+  QFile file{name};
+  if (!file.open(QFile::ReadOnly | QFile::Unbuffered)) return std::nullopt;
+
+  const auto buffer = std::make_unique_for_overwrite<std::byte[]>(kBufferSize);
+  std::uint32_t crc = 0;
+
+  while (true) {
+    const auto bytes = file.read(reinterpret_cast<char*>(buffer.get()), kBufferSize);
+    if (bytes < 0) return std::nullopt;
+    if (bytes == 0) break;
+    crc = crc32({buffer.get(), static_cast<size_t>(bytes)}, crc);
+  }
+
+  return crc;
+}
+
 }  // namespace base
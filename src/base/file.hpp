@@ -19,9 +19,12 @@
 #pragma once
 
 #include <QString>
+#include <cstdint>
+#include <optional>
 
 namespace base {
 
 QString readFile(const QString& name);
+std::optional<std::uint32_t> crc32File(const QString& name);
 
 }  // namespace base
@@ -0,0 +1,206 @@
+/**
+ * Taiga
+ * Copyright (C) 2010-2025, Eren Okka
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "json.hpp"
+
+#include <optional>
+
+namespace base {
+
+namespace {
+
+constexpr bool isWhitespace(const char c) {
+  return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+constexpr bool isLiteral(const char c) {
+  return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || c == '-' || c == '+' || c == '.' ||
+         c == 'E';
+}
+
+}  // namespace
+
+void JsonStreamReader::addPath(path_t path, value_callback_t callback) {
+  if (paths_.size() < kMaxPaths) {
+    paths_.emplace_back(std::move(path), std::move(callback));
+  }
+}
+
+bool JsonStreamReader::feed(std::string_view data) {
+  if (error_) return false;
+
+  // Start of the value being captured within this chunk
+  std::size_t capture_begin = 0;
+
+  const auto fail = [this]() {
+    error_ = true;
+    return false;
+  };
+
+  // Returns the paths that a container starting here lies on
+  const auto beginValue = [&](const std::size_t pos) -> std::optional<std::uint32_t> {
+    std::uint32_t paths = 0;
+    const auto depth = stack_.size();
+
+    if (stack_.empty()) {
+      if (started_) return std::nullopt;
+      started_ = true;
+      paths = static_cast<std::uint32_t>((std::uint64_t{1} << paths_.size()) - 1);
+    } else {
+      auto& parent = stack_.back();
+      if (parent.expect != Expect::Value) return std::nullopt;
+      const std::string_view component = parent.is_object ? std::string_view{key_} : "[]";
+      for (std::size_t i = 0; i < paths_.size(); ++i) {
+        const auto& keys = paths_[i].keys;
+        if ((parent.paths & (1u << i)) && keys.size() >= depth && keys[depth - 1] == component) {
+          paths |= 1u << i;
+        }
+      }
+    }
+
+    if (capture_ < 0) {
+      for (std::size_t i = 0; i < paths_.size(); ++i) {
+        if ((paths & (1u << i)) && paths_[i].keys.size() == depth) {
+          capture_ = static_cast<int>(i);
+          capture_depth_ = depth;
+          capture_begin = pos;
+          buffer_.clear();
+          break;
+        }
+      }
+    }
+
+    // Values under a captured value are not reported
+    return capture_ >= 0 ? 0 : paths;
+  };
+
+  const auto endValue = [&](const std::size_t end) {
+    if (!stack_.empty()) stack_.back().expect = Expect::Comma;
+    if (capture_ >= 0 && stack_.size() == capture_depth_) {
+      buffer_.append(data.substr(capture_begin, end - capture_begin));
+      const auto& callback = paths_[capture_].callback;
+      capture_ = -1;
+      if (callback) callback(buffer_);
+      buffer_.clear();
+    }
+    if (stack_.empty()) finished_ = true;
+  };
+
+  for (std::size_t pos = 0; pos < data.size(); ++pos) {
+    const char c = data[pos];
+
+    if (token_ == Token::Key || token_ == Token::String) {
+      if (escaped_) {
+        escaped_ = false;
+      } else if (c == '\\') {
+        escaped_ = true;
+      } else if (c == '"') {
+        if (token_ == Token::Key) {
+          stack_.back().expect = Expect::Colon;
+        } else {
+          token_ = Token::None;
+          endValue(pos + 1);
+          continue;
+        }
+        token_ = Token::None;
+        continue;
+      }
+      if (token_ == Token::Key) key_.push_back(c);
+      continue;
+    }
+
+    if (token_ == Token::Literal) {
+      if (isLiteral(c)) continue;
+      token_ = Token::None;
+      endValue(pos);
+    }
+
+    if (isWhitespace(c)) continue;
+
+    if (finished_) return fail();
+
+    switch (c) {
+      case '{':
+      case '[': {
+        const auto paths = beginValue(pos);
+        if (!paths) return fail();
+        stack_.push_back({
+            .is_object = c == '{',
+            .expect = c == '{' ? Expect::Key : Expect::Value,
+            .paths = *paths,
+        });
+        break;
+      }
+
+      case '}':
+      case ']': {
+        if (stack_.empty() || stack_.back().is_object != (c == '}')) return fail();
+        if (const auto expect = stack_.back().expect; expect == Expect::Colon ||
+                                                      (expect == Expect::Value && stack_.back().is_object)) {
+          return fail();
+        }
+        stack_.pop_back();
+        endValue(pos + 1);
+        break;
+      }
+
+      case '"': {
+        if (!stack_.empty() && stack_.back().is_object && stack_.back().expect == Expect::Key) {
+          token_ = Token::Key;
+          key_.clear();
+        } else {
+          if (!beginValue(pos)) return fail();
+          token_ = Token::String;
+        }
+        break;
+      }
+
+      case ':': {
+        if (stack_.empty() || stack_.back().expect != Expect::Colon) return fail();
+        stack_.back().expect = Expect::Value;
+        break;
+      }
+
+      case ',': {
+        if (stack_.empty() || stack_.back().expect != Expect::Comma) return fail();
+        stack_.back().expect = stack_.back().is_object ? Expect::Key : Expect::Value;
+        break;
+      }
+
+      default: {
+        if (!isLiteral(c) || !beginValue(pos)) return fail();
+        token_ = Token::Literal;
+        break;
+      }
+    }
+  }
+
+  if (capture_ >= 0) buffer_.append(data.substr(capture_begin));
+
+  return true;
+}
+
+bool JsonStreamReader::hasError() const {
+  return error_;
+}
+
+bool JsonStreamReader::isFinished() const {
+  return finished_;
+}
+
+}  // namespace base
@@ -0,0 +1,93 @@
+/**
+ * Taiga
+ * Copyright (C) 2010-2025, Eren Okka
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace base {
+
+// Reads a JSON document in chunks, as they arrive, and passes the raw text of
+// the values found at the given paths to a callback. Only one value is held in
+// memory at a time, rather than the whole document.
+//
+// A path is a list of object keys, where "[]" matches every element of an
+// array, e.g. `{"data", "items", "[]"}`. Values under an already matched value
+// are not reported.
+class JsonStreamReader {
+public:
+  using path_t = std::vector<std::string>;
+  using value_callback_t = std::function<void(std::string_view)>;
+
+  static constexpr std::size_t kMaxPaths = 32;
+
+  void addPath(path_t path, value_callback_t callback);
+
+  bool feed(std::string_view data);
+
+  bool hasError() const;
+  bool isFinished() const;
+
+private:
+  enum class Token {
+    None,
+    Key,
+    String,
+    Literal,
+  };
+
+  enum class Expect {
+    Key,
+    Colon,
+    Value,
+    Comma,
+  };
+
+  struct Frame {
+    bool is_object = false;
+    Expect expect = Expect::Value;
+    std::uint32_t paths = 0;
+  };
+
+  struct Path {
+    path_t keys;
+    value_callback_t callback;
+  };
+
+  std::vector<Path> paths_;
+  std::vector<Frame> stack_;
+
+  Token token_ = Token::None;
+  bool escaped_ = false;
+  std::string key_;
+
+  int capture_ = -1;
+  std::size_t capture_depth_ = 0;
+  std::string buffer_;
+
+  bool started_ = false;
+  bool finished_ = false;
+  bool error_ = false;
+};
+
+}  // namespace base
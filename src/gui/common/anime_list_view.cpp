@@ -54,6 +54,7 @@ ListView::ListView(QWidget* parent, AnimeListModel* model, AnimeListProxyModel*
   header()->hideSection(AnimeListModel::COLUMN_STARTED);
   header()->hideSection(AnimeListModel::COLUMN_COMPLETED);
   header()->hideSection(AnimeListModel::COLUMN_NOTES);
+  header()->hideSection(AnimeListModel::COLUMN_AVAILABLE);
   header()->resizeSection(AnimeListModel::COLUMN_TITLE, 295);
   header()->resizeSection(AnimeListModel::COLUMN_PROGRESS, 150);
   header()->resizeSection(AnimeListModel::COLUMN_DURATION, 75);
@@ -61,6 +62,7 @@ ListView::ListView(QWidget* parent, AnimeListModel* model, AnimeListProxyModel*
   header()->resizeSection(AnimeListModel::COLUMN_AVERAGE, 75);
   header()->resizeSection(AnimeListModel::COLUMN_TYPE, 75);
   header()->resizeSection(AnimeListModel::COLUMN_LAST_UPDATED, 110);
+  header()->resizeSection(AnimeListModel::COLUMN_AVAILABLE, 75);
 
   // `sortByColumn` needs to be called before `setSortingEnabled`.
   // Otherwise the sort column is set to `0`.
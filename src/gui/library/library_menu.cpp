@@ -25,6 +25,7 @@
 #include "gui/media/media_menu.hpp"
 #include "gui/utils/theme.hpp"
 #include "media/anime_db.hpp"
+#include "track/library.hpp"
 
 namespace gui {
 
@@ -40,6 +41,8 @@ void LibraryMenu::popup() {
   addSeparator();
   addAction(theme.getIcon("delete"), tr("Delete"), tr("Del"), this, &LibraryMenu::remove);
   addAction(theme.getIcon("edit"), tr("Rename"), tr("F2"), this, &LibraryMenu::rename);
+  addSeparator();
+  addAction(theme.getIcon("check_circle"), tr("Verify checksums"), this, &LibraryMenu::verify);
 
   if (const auto item = anime::db.item(m_anime_id)) {
     addSeparator();
@@ -61,6 +64,10 @@ void LibraryMenu::rename() const {
   // @TODO
 }
 
+void LibraryMenu::verify() const {
+  track::library.verify(m_path);
+}
+
 void LibraryMenu::viewDetails() const {
   const auto item = anime::db.item(m_anime_id);
   const auto entry = anime::db.entry(m_anime_id);
@@ -37,6 +37,7 @@ private slots:
   void open() const;
   void remove() const;
   void rename() const;
+  void verify() const;
   void viewDetails() const;
 
 private:
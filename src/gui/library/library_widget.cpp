@@ -21,6 +21,7 @@
 #include <QDesktopServices>
 #include <QHeaderView>
 #include <QLayout>
+#include <QMessageBox>
 #include <QUrl>
 
 #include "gui/library/library_menu.hpp"
@@ -28,6 +29,7 @@
 #include "gui/models/library_model.hpp"
 #include "gui/utils/theme.hpp"
 #include "taiga/settings.hpp"
+#include "track/library.hpp"
 #include "ui_main_window.h"
 
 namespace gui {
@@ -36,6 +38,7 @@ LibraryWidget::LibraryWidget(QWidget* parent)
     : PageWidget{parent},
       m_model(new LibraryModel(parent)),
       m_comboRoot(new ComboBox(this)),
+      m_labelScan(new QLabel(this)),
       m_view(new QTreeView(parent)) {
   const auto libraryFolders = taiga::settings.libraryFolders();
   const auto rootPath =
@@ -60,8 +63,25 @@ LibraryWidget::LibraryWidget(QWidget* parent)
     filtersLayout->addWidget(m_comboRoot);
   }
 
+  // Scan status
+  {
+    m_labelScan->hide();
+    m_toolbarLayout->insertWidget(m_toolbarLayout->indexOf(m_toolbar), m_labelScan);
+  }
+
   // Toolbar
   {
+    // Scan library
+    m_actionScan = new QAction(theme.getIcon("sync"), tr("Scan library"), this);
+    connect(m_actionScan, &QAction::triggered, this, []() {
+      if (track::library.isScanning()) {
+        track::library.cancelScan();
+      } else {
+        track::library.scan();
+      }
+    });
+    m_toolbar->addAction(m_actionScan);
+
     // Play next episode
     m_toolbar->addAction(mainWindow()->ui()->actionPlayNextEpisode);
 
@@ -102,6 +122,31 @@ LibraryWidget::LibraryWidget(QWidget* parent)
 
   connect(m_view, &QWidget::customContextMenuRequested, this, &LibraryWidget::showContextMenu);
 
+  connect(&track::library, &track::Library::scanProgress, this,
+          &LibraryWidget::updateScanStatus);
+  connect(&track::library, &track::Library::scanFinished, this,
+          [this]() { updateScanStatus(0, 0); });
+
+  connect(&track::library, &track::Library::verificationFinished, this,
+          [this](const QString& path, int count, const QStringList& failed) {
+            if (!count) {
+              QMessageBox::information(
+                  this, tr("Verify Checksums"),
+                  tr("No files with checksums in their names were found in %1.").arg(path));
+            } else if (failed.isEmpty()) {
+              QMessageBox::information(
+                  this, tr("Verify Checksums"),
+                  tr("Verified %1 files in %2, no problems found.").arg(count).arg(path));
+            } else {
+              QMessageBox::warning(this, tr("Verify Checksums"),
+                                   tr("%1 of %2 files in %3 failed verification:\n\n%4")
+                                       .arg(failed.size())
+                                       .arg(count)
+                                       .arg(path)
+                                       .arg(failed.join("\n")));
+            }
+          });
+
   connect(m_view, &QTreeView::doubleClicked, this, [this](const QModelIndex& index) {
     if (!index.isValid()) return;
     if (!(index.flags() & Qt::ItemIsEnabled)) return;
@@ -112,6 +157,15 @@ LibraryWidget::LibraryWidget(QWidget* parent)
   });
 }
 
+void LibraryWidget::updateScanStatus(int folders, int files) const {
+  const bool isScanning = track::library.isScanning();
+
+  m_labelScan->setText(tr("Scanning: %1 folders, %2 files").arg(folders).arg(files));
+  m_labelScan->setVisible(isScanning);
+
+  m_actionScan->setText(isScanning ? tr("Stop scanning") : tr("Scan library"));
+}
+
 void LibraryWidget::showContextMenu() const {
   const auto index = m_view->currentIndex();
 
@@ -18,6 +18,7 @@
 
 #pragma once
 
+#include <QLabel>
 #include <QTreeView>
 
 #include "gui/common/combobox.hpp"
@@ -37,9 +38,12 @@ public:
 
 private:
   void showContextMenu() const;
+  void updateScanStatus(int folders, int files) const;
 
   LibraryModel* m_model = nullptr;
   ComboBox* m_comboRoot = nullptr;
+  QLabel* m_labelScan = nullptr;
+  QAction* m_actionScan = nullptr;
   QTreeView* m_view = nullptr;
 };
 
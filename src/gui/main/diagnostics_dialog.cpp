@@ -0,0 +1,142 @@
+/**
+ * Taiga
+ * Copyright (C) 2010-2025, Eren Okka
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "diagnostics_dialog.hpp"
+
+#include <QDialogButtonBox>
+#include <QFile>
+#include <QFileDialog>
+#include <QHeaderView>
+#include <QLabel>
+#include <QPushButton>
+#include <QTableWidget>
+#include <QVBoxLayout>
+#include <algorithm>
+
+#include "base/string.hpp"
+#include "gui/utils/image_provider.hpp"
+#include "sync/trace.hpp"
+#include "taiga/network.hpp"
+
+namespace gui {
+
+namespace {
+
+QString formatDuration(const std::chrono::microseconds duration) {
+  return QString::number(duration.count() / 1000.0, 'f', 1);
+}
+
+}  // namespace
+
+DiagnosticsDialog::DiagnosticsDialog(QWidget* parent)
+    : QDialog(parent), m_labelNetwork(new QLabel(this)), m_table(new QTableWidget(this)) {
+  setWindowTitle(tr("Network Diagnostics"));
+  resize(720, 480);
+
+  m_table->setColumnCount(7);
+  m_table->setHorizontalHeaderLabels({
+      tr("Service"),
+      tr("Operation"),
+      tr("Span"),
+      tr("Requests"),
+      tr("p50 (ms)"),
+      tr("p90 (ms)"),
+      tr("p99 (ms)"),
+  });
+  m_table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+  m_table->setSelectionBehavior(QAbstractItemView::SelectRows);
+  m_table->verticalHeader()->hide();
+  m_table->horizontalHeader()->setSectionResizeMode(QHeaderView::ResizeToContents);
+  m_table->horizontalHeader()->setStretchLastSection(true);
+
+  auto buttonBox = new QDialogButtonBox(QDialogButtonBox::Close, this);
+  auto buttonRefresh = buttonBox->addButton(tr("Refresh"), QDialogButtonBox::ActionRole);
+  auto buttonSave = buttonBox->addButton(tr("Save trace..."), QDialogButtonBox::ActionRole);
+  connect(buttonBox, &QDialogButtonBox::rejected, this, &QDialog::reject);
+  connect(buttonRefresh, &QPushButton::clicked, this, &DiagnosticsDialog::refresh);
+  connect(buttonSave, &QPushButton::clicked, this, &DiagnosticsDialog::saveTrace);
+
+  auto layout = new QVBoxLayout(this);
+  layout->addWidget(m_table);
+  layout->addWidget(m_labelNetwork);
+  layout->addWidget(buttonBox);
+
+  refresh();
+}
+
+void DiagnosticsDialog::show(QWidget* parent) {
+  auto* dlg = new DiagnosticsDialog(parent);
+  dlg->setAttribute(Qt::WA_DeleteOnClose);
+  dlg->QDialog::show();
+}
+
+void DiagnosticsDialog::refresh() {
+  const auto summary = sync::tracer.summary();
+
+  m_table->setRowCount(summary.size());
+
+  for (int row = 0; const auto& span : summary) {
+    const QStringList values{
+        span.service,
+        span.operation,
+        sync::spanName(span.span),
+        QString::number(span.count),
+        formatDuration(span.p50),
+        formatDuration(span.p90),
+        formatDuration(span.p99),
+    };
+    for (int column = 0; column < values.size(); ++column) {
+      auto item = new QTableWidgetItem(values[column]);
+      if (column > 2) item->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+      m_table->setItem(row, column, item);
+    }
+    ++row;
+  }
+
+  const auto& cache = taiga::network()->cacheStats();
+  const auto& connections = taiga::network()->connectionStats();
+  const QStringList lines{
+      tr("Cache: %1 hits, %2 misses, %3 saved")
+          .arg(cache.hits)
+          .arg(cache.misses)
+          .arg(locale().formattedDataSize(cache.bytes_saved)),
+      tr("Connections: %1 requests, %2 reused, %3 over HTTP/2")
+          .arg(connections.requests)
+          .arg(std::max(0, connections.requests - connections.connections))
+          .arg(connections.http2),
+      tr("Posters: %1 hits, %2 misses, %3 evicted, %4 in memory")
+          .arg(imageProvider.cacheStats().hits)
+          .arg(imageProvider.cacheStats().misses)
+          .arg(imageProvider.cacheStats().evictions)
+          .arg(locale().formattedDataSize(imageProvider.cacheSize())),
+  };
+  m_labelNetwork->setText(lines.join('\n'));
+}
+
+void DiagnosticsDialog::saveTrace() {
+  const auto fileName = QFileDialog::getSaveFileName(this, tr("Save Trace"), u"trace.json"_s,
+                                                     tr("JSON files (*.json)"));
+
+  if (fileName.isEmpty()) return;
+
+  QFile file{fileName};
+  if (!file.open(QIODevice::WriteOnly)) return;
+  file.write(sync::tracer.toJson());
+}
+
+}  // namespace gui
@@ -27,6 +27,7 @@
 #include "gui/library/library_widget.hpp"
 #include "gui/list/list_widget.hpp"
 #include "gui/main/about_dialog.hpp"
+#include "gui/main/diagnostics_dialog.hpp"
 #include "gui/main/navigation_widget.hpp"
 #include "gui/main/now_playing_widget.hpp"
 #include "gui/search/search_widget.hpp"
@@ -105,10 +106,13 @@ void MainWindow::initActions() {
   connect(ui_->actionAbout, &QAction::triggered, this, &MainWindow::about);
   connect(ui_->actionDonate, &QAction::triggered, this, &MainWindow::donate);
   connect(ui_->actionSupport, &QAction::triggered, this, &MainWindow::support);
+  connect(ui_->actionDiagnostics, &QAction::triggered, this,
+          [this]() { DiagnosticsDialog::show(this); });
   connect(ui_->actionProfile, &QAction::triggered, this, &MainWindow::profile);
   connect(ui_->actionDisplayWindow, &QAction::triggered, this, &MainWindow::displayWindow);
 
   connect(ui_->actionSynchronize, &QAction::triggered, this, [this]() {
+    sync::synchronize();
     setEnabled(false);
     statusBar()->showMessage(
         tr("Synchronizing with %1...").arg(sync::serviceName(sync::currentServiceId())));
@@ -130,6 +134,7 @@ void MainWindow::initIcons() {
   ui_->actionAbout->setIcon(theme.getIcon("info"));
   ui_->actionBack->setIcon(theme.getIcon("arrow_back"));
   ui_->actionCheckForUpdates->setIcon(theme.getIcon("cloud_download"));
+  ui_->actionDiagnostics->setIcon(theme.getIcon("bar_chart"));
   ui_->actionDonate->setIcon(theme.getIcon("favorite"));
   ui_->actionExit->setIcon(theme.getIcon("logout"));
   ui_->actionForward->setIcon(theme.getIcon("arrow_forward"));
@@ -316,7 +316,6 @@ void MediaDialog::loadPosterImage() {
   const auto posterPixmap = imageProvider.loadPoster(m_anime.id);
   ui_->posterLabel->setPixmap(*posterPixmap);
   resizePosterImage();
-  if (posterPixmap->isNull()) imageProvider.fetchPoster(m_anime.id);
 }
 
 void MediaDialog::resizePosterImage() {
@@ -352,8 +351,7 @@ void MediaDialog::accept() {
   m_entry->notes = ui_->plainTextEditNotes->toPlainText().toStdString();
   m_entry->last_updated = QDateTime::currentSecsSinceEpoch();
 
-  // @TODO: Add to queue instead
-  anime::db.updateEntry(*m_entry);
+  anime::db.queueEntry(*m_entry);
 
   QDialog::accept();
 }
@@ -22,6 +22,7 @@
 #include <QInputDialog>
 #include <QItemSelectionModel>
 #include <QMessageBox>
+#include <QRandomGenerator>
 #include <QUrl>
 #include <QUrlQuery>
 #include <ranges>
@@ -36,6 +37,7 @@
 #include "media/anime_utils.hpp"
 #include "sync/service.hpp"
 #include "taiga/settings.hpp"
+#include "track/library.hpp"
 #include "track/play.hpp"
 #include "track/scanner.hpp"
 
@@ -430,19 +432,34 @@ void MediaMenu::addLibraryItems() {
 
     if (total_episodes > 1) {
       // Play random episode
-      menu->addAction(theme.getIcon("shuffle"), tr("Random episode"), this, [this]() {
-        const int number = 3;  // @TODO
-        playEpisode(number);
-      });
+      menu->addAction(theme.getIcon("shuffle"), tr("Random episode"), this,
+                      [this, id = item.id, total_episodes]() {
+                        // Prefer episodes that are known to be available
+                        const int count = track::library.countAvailable(id);
+                        if (!count) {
+                          playEpisode(1 + QRandomGenerator::global()->bounded(total_episodes));
+                          return;
+                        }
+                        int number = 0;
+                        for (int i = QRandomGenerator::global()->bounded(count); i >= 0; --i) {
+                          number = track::library.nextAvailable(id, number);
+                        }
+                        playEpisode(number);
+                      });
 
       // Play episode
       menu->addSeparator();
-      menu->addMenu([this, total_episodes, last_episode]() {
+      menu->addMenu([this, id = item.id, total_episodes, last_episode]() {
         auto menu = new QMenu(tr("Episode"), this);
         for (int i = 1; i <= total_episodes; ++i) {
           auto action = new QAction(u"#%1"_s.arg(i), this);
           action->setCheckable(true);
           action->setChecked(i <= last_episode);
+          if (track::library.isAvailable(id, i)) {
+            auto font = action->font();
+            font.setBold(true);
+            action->setFont(font);
+          }
           menu->addAction(action);
           connect(action, &QAction::triggered, this, [this, i]() { playEpisode(i); });
         }
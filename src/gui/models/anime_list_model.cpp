@@ -29,6 +29,7 @@
 #include "gui/utils/image_provider.hpp"
 #include "media/anime_db.hpp"
 #include "media/anime_season.hpp"
+#include "track/library.hpp"
 
 namespace gui {
 
@@ -42,6 +43,25 @@ AnimeListModel::AnimeListModel(QObject* parent) : QAbstractListModel(parent) {
       emit dataChanged(index(row), index(row), {static_cast<int>(AnimeListItemDataRole::Poster)});
     }
   });
+
+  const auto updateRow = [this](const int id) {
+    if (const auto row = m_ids.indexOf(id); row > -1) {
+      emit dataChanged(index(row, 0), index(row, columnCount() - 1));
+    }
+  };
+  connect(&anime::db, &anime::Database::itemUpdated, this, updateRow);
+  connect(&anime::db, &anime::Database::entryUpdated, this, updateRow);
+
+  connect(&anime::db, &anime::Database::listUpdated, this, [this]() {
+    beginResetModel();
+    m_ids = anime::db.items().keys();
+    endResetModel();
+  });
+
+  connect(&track::library, &track::Library::scanFinished, this, [this]() {
+    if (m_ids.isEmpty()) return;
+    emit dataChanged(index(0, COLUMN_AVAILABLE), index(m_ids.size() - 1, COLUMN_AVAILABLE));
+  });
 }
 
 int AnimeListModel::rowCount(const QModelIndex&) const {
@@ -91,6 +111,8 @@ QVariant AnimeListModel::data(const QModelIndex& index, int role) const {
         case COLUMN_NOTES:
           if (entry) return QString::fromStdString(entry->notes);
           break;
+        case COLUMN_AVAILABLE:
+          return formatNumber(track::library.countAvailable(anime->id));
       }
       break;
 
@@ -116,6 +138,7 @@ QVariant AnimeListModel::data(const QModelIndex& index, int role) const {
         case COLUMN_SCORE:
         case COLUMN_AVERAGE:
         case COLUMN_TYPE:
+        case COLUMN_AVAILABLE:
           return QVariant(Qt::AlignHCenter | Qt::AlignVCenter);
         case COLUMN_DURATION:
         case COLUMN_SEASON:
@@ -157,6 +180,9 @@ QVariant AnimeListModel::data(const QModelIndex& index, int role) const {
         case COLUMN_LAST_UPDATED:
           if (entry && !entry->last_updated) return disabledTextColor;
           break;
+        case COLUMN_AVAILABLE:
+          if (!track::library.countAvailable(anime->id)) return disabledTextColor;
+          break;
       }
       break;
     }
@@ -168,18 +194,27 @@ QVariant AnimeListModel::data(const QModelIndex& index, int role) const {
       return QVariant::fromValue(entry);
     }
     case static_cast<int>(AnimeListItemDataRole::Poster): {
-      return QVariant::fromValue(imageProvider.loadPoster(anime->id));
+      return QVariant::fromValue(imageProvider.loadPoster(anime->id, PosterSize::Thumbnail));
+    }
+    // Copied, because the index is replaced by the next scan
+    case static_cast<int>(AnimeListItemDataRole::Availability): {
+      const auto item = track::library.item(anime->id);
+      return QVariant::fromValue(item ? item->episodes : track::EpisodeAvailability{});
     }
   }
 
   return {};
 }
 
-bool AnimeListModel::setData(const QModelIndex& index, const QVariant&, int role) {
+bool AnimeListModel::setData(const QModelIndex& index, const QVariant& value, int role) {
   if (index.isValid() && role == Qt::EditRole) {
     if (index.column() == COLUMN_SCORE) {
-      // const int id = m_ids.at(index.row());
-      // @TODO: Add to queue
+      const auto entry = anime::db.entry(m_ids.at(index.row()));
+      if (!entry) return false;
+      auto changed = *entry;
+      changed.score = value.toInt();
+      changed.last_updated = QDateTime::currentSecsSinceEpoch();
+      anime::db.queueEntry(changed);
       return true;
     }
   }
@@ -203,6 +238,7 @@ QVariant AnimeListModel::headerData(int section, Qt::Orientation orientation, in
         case COLUMN_COMPLETED: return tr("Completed");
         case COLUMN_LAST_UPDATED: return tr("Last updated");
         case COLUMN_NOTES: return tr("Notes");
+        case COLUMN_AVAILABLE: return tr("Available");
       }
       // clang-format on
       break;
@@ -215,6 +251,7 @@ QVariant AnimeListModel::headerData(int section, Qt::Orientation orientation, in
         case COLUMN_SCORE:
         case COLUMN_AVERAGE:
         case COLUMN_TYPE:
+        case COLUMN_AVAILABLE:
           return QVariant(Qt::AlignHCenter | Qt::AlignVCenter);
         case COLUMN_DURATION:
         case COLUMN_SEASON:
@@ -237,6 +274,7 @@ QVariant AnimeListModel::headerData(int section, Qt::Orientation orientation, in
         case COLUMN_STARTED:
         case COLUMN_COMPLETED:
         case COLUMN_LAST_UPDATED:
+        case COLUMN_AVAILABLE:
           return Qt::DescendingOrder;
         default:
           return Qt::AscendingOrder;
@@ -30,6 +30,7 @@ enum class AnimeListItemDataRole {
   Anime = Qt::UserRole,
   ListEntry,
   Poster,
+  Availability,
 };
 
 class AnimeListModel final : public QAbstractListModel {
@@ -50,6 +51,7 @@ public:
     COLUMN_COMPLETED,
     COLUMN_LAST_UPDATED,
     COLUMN_NOTES,
+    COLUMN_AVAILABLE,
     NUM_COLUMNS
   };
 
@@ -27,6 +27,7 @@
 #include "media/anime_list_utils.hpp"
 #include "media/anime_season.hpp"
 #include "media/anime_utils.hpp"
+#include "track/library.hpp"
 
 namespace {
 
@@ -213,6 +214,10 @@ bool AnimeListProxyModel::lessThan(const QModelIndex& lhs, const QModelIndex& rh
 
     case AnimeListModel::COLUMN_NOTES:
       return (lhs_entry ? lhs_entry->notes : "") < (rhs_entry ? rhs_entry->notes : "");
+
+    case AnimeListModel::COLUMN_AVAILABLE:
+      return track::library.countAvailable(lhs_anime->id) <
+             track::library.countAvailable(rhs_anime->id);
   }
 
   return false;
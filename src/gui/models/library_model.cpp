@@ -19,15 +19,28 @@
 #include "library_model.hpp"
 
 #include <QApplication>
+#include <QDir>
 #include <QPalette>
 #include <anitomy.hpp>
 #include <anitomy/detail/keyword.hpp>  // don't try this at home
+#include <format>
 #include <ranges>
 
 #include "base/string.hpp"
 #include "media/anime_db.hpp"
+#include "taiga/settings.hpp"
 #include "track/episode.hpp"
-#include "track/recognition.hpp"
+#include "track/file_walker.hpp"
+#include "track/recognition_cache.hpp"
+#include "track/scanner.hpp"
+
+namespace {
+
+// Files are recognized in batches, so that results are applied in a few
+// model updates rather than one per file.
+constexpr qsizetype kBatchSize = 200;
+
+}  // namespace
 
 namespace gui {
 
@@ -45,6 +58,11 @@ LibraryModel::LibraryModel(QObject* parent) : QFileSystemModel(parent) {
   connect(this, &QFileSystemModel::directoryLoaded, this, &LibraryModel::parseDirectory);
 }
 
+LibraryModel::~LibraryModel() {
+  m_pool.clear();
+  m_pool.waitForDone();
+}
+
 int LibraryModel::columnCount(const QModelIndex&) const {
   return NUM_COLUMNS;
 }
@@ -147,21 +165,31 @@ bool LibraryModel::isEnabled(const QModelIndex& index) const {
   return index.flags() & Qt::ItemIsEnabled;
 }
 
+const LibraryModel::ParsedData* LibraryModel::find(const QString& path) const {
+  const auto it = m_parsed.find(qHash(path));
+  return it != m_parsed.end() ? &it->second : nullptr;
+}
+
 QString LibraryModel::getTitle(const QString& path) const {
-  if (m_parsed[path].id) {
-    const auto item = anime::db.item(m_parsed[path].id);
+  const auto parsed = find(path);
+  if (!parsed) return {};
+
+  if (parsed->id) {
+    const auto item = anime::db.item(parsed->id);
     if (item) return QString::fromStdString(item->titles.romaji);
   }
 
-  return m_parsed[path].title;
+  return parsed->title;
 }
 
 QString LibraryModel::getEpisode(const QString& path) const {
-  return m_parsed[path].episode;
+  const auto parsed = find(path);
+  return parsed ? parsed->episode : QString{};
 }
 
 int LibraryModel::getId(const QString& path) const {
-  return m_parsed[path].id;
+  const auto parsed = find(path);
+  return parsed ? parsed->id : 0;
 }
 
 void LibraryModel::parseDirectory(const QString& path) {
@@ -169,29 +197,102 @@ void LibraryModel::parseDirectory(const QString& path) {
 
   if (!parent.isValid()) return;
 
+  QList<file_t> files;
+
   for (int i = 0; i < rowCount(parent); ++i) {
     const auto child = index(i, 0, parent);
     if (!child.isValid()) continue;
     if (!isEnabled(child)) continue;
     const auto info = fileInfo(child);
     if (!info.isFile()) continue;
-    parseFileInfo(info);
+    const auto key = qHash(info.filePath());
+    if (m_parsed.contains(key) || m_pending.contains(key)) continue;
+    m_pending.insert(key);
+    files.emplace_back(key, info.fileName());
+  }
+
+  if (files.isEmpty()) return;
+
+  const auto scanner = scanFolders(path);
+
+  for (qsizetype i = 0; i < files.size(); i += kBatchSize) {
+    m_pool.start([this, path, batch = files.mid(i, kBatchSize), scanner]() {
+      const auto results = parseFiles(*scanner, path, batch);
+      QMetaObject::invokeMethod(
+          this, [this, path, results]() { applyResults(path, results); }, Qt::QueuedConnection);
+    });
   }
 }
 
-void LibraryModel::parseFileInfo(const QFileInfo& info) {
-  const auto path = info.filePath();
+void LibraryModel::applyResults(const QString& path, const QList<result_t>& results) {
+  for (const auto& [key, parsed] : results) {
+    m_pending.erase(key);
+    m_parsed.insert_or_assign(key, parsed);
+  }
 
-  if (m_parsed.contains(path)) return;
+  const auto parent = index(path);
+
+  if (!parent.isValid()) return;
 
-  auto episode = track::recognition::parseFileInfo(info);
-  const auto anime_id = track::recognition::identify(episode);
+  if (const int rows = rowCount(parent); rows > 0) {
+    emit dataChanged(index(0, COLUMN_ANIME, parent), index(rows - 1, COLUMN_EPISODE, parent));
+  }
+}
+
+// Folders inherit the anime of their parents, the same as when the library is
+// indexed, so each folder below the library root is identified in turn. The
+// scanner is shared by all batches, which only read from it.
+std::shared_ptr<const track::Scanner> LibraryModel::scanFolders(const QString& path) {
+  auto scanner = std::make_shared<track::Scanner>(track::recognition::cache());
+
+  const auto dirPath = QDir::cleanPath(path);
+  auto parent = QFileInfo{dirPath}.path();
+
+  for (const auto& folder : taiga::settings.libraryFolders()) {
+    const auto root = QDir::cleanPath(QString::fromStdString(folder));
+    if (dirPath.startsWith(root + '/')) {
+      parent = root;
+      break;
+    }
+  }
+
+  for (const auto& name : dirPath.mid(parent.size() + 1).split('/', Qt::SkipEmptyParts)) {
+    const auto parentPath = parent.toStdString();
+    const auto dirName = name.toStdString();
+    scanner->scanDirectory({.directory = parentPath, .name = dirName, .is_directory = true});
+    parent = u"%1/%2"_s.arg(parent, name);
+  }
+
+  return scanner;
+}
+
+// Runs on a worker thread
+QList<LibraryModel::result_t> LibraryModel::parseFiles(const track::Scanner& scanner,
+                                                       const QString& path,
+                                                       const QList<file_t>& files) {
+  const auto dirPath = QDir::cleanPath(path).toStdString();
+
+  QList<result_t> results;
+  results.reserve(files.size());
+
+  for (const auto& [key, fileName] : files) {
+    const auto name = fileName.toStdString();
+    const track::FileEntry entry{.directory = dirPath, .name = name};
+
+    auto episode = scanner.parseFile(entry);
+    const int anime_id = scanner.identifyFile(entry, episode);
+
+    results.emplace_back(key,
+                         ParsedData{
+                             .title = QString::fromStdString(
+                                 episode.element(anitomy::ElementKind::Title)),
+                             .episode = QString::fromStdString(
+                                 episode.element(anitomy::ElementKind::Episode)),
+                             .id = anime_id,
+                         });
+  }
 
-  m_parsed[path] = ParsedData{
-      .title = QString::fromStdString(episode.element(anitomy::ElementKind::Title)),
-      .episode = QString::fromStdString(episode.element(anitomy::ElementKind::Episode)),
-      .id = anime_id,
-  };
+  return results;
 }
 
 }  // namespace gui
@@ -20,6 +20,16 @@
 
 #include <QFileInfo>
 #include <QFileSystemModel>
+#include <QList>
+#include <QThreadPool>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
+namespace track {
+class Scanner;
+}
 
 namespace gui {
 
@@ -39,7 +49,7 @@ public:
   };
 
   LibraryModel(QObject* parent);
-  ~LibraryModel() = default;
+  ~LibraryModel() override;
 
   int columnCount(const QModelIndex& parent = {}) const override;
   QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
@@ -56,12 +66,23 @@ private:
     int id = 0;
   };
 
+  using key_t = size_t;
+  using file_t = std::pair<key_t, QString>;
+  using result_t = std::pair<key_t, ParsedData>;
+
   bool isEnabled(const QModelIndex& index) const;
+  const ParsedData* find(const QString& path) const;
 
   void parseDirectory(const QString& path);
-  void parseFileInfo(const QFileInfo& info);
+  void applyResults(const QString& path, const QList<result_t>& results);
+
+  static std::shared_ptr<const track::Scanner> scanFolders(const QString& path);
+  static QList<result_t> parseFiles(const track::Scanner& scanner, const QString& path,
+                                    const QList<file_t>& files);
 
-  QMap<QString, ParsedData> m_parsed;
+  std::unordered_map<key_t, ParsedData> m_parsed;
+  std::unordered_set<key_t> m_pending;
+  QThreadPool m_pool;
 };
 
 }  // namespace gui
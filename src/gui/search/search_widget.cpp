@@ -18,6 +18,7 @@
 
 #include "search_widget.hpp"
 
+#include <QTimer>
 #include <QToolBar>
 
 #include "gui/common/anime_list_view_cards.hpp"
@@ -27,6 +28,7 @@
 #include "gui/utils/theme.hpp"
 #include "media/anime.hpp"
 #include "media/anime_season.hpp"
+#include "sync/service.hpp"
 #include "taiga/session.hpp"
 
 namespace gui {
@@ -39,7 +41,8 @@ SearchWidget::SearchWidget(QWidget* parent)
       m_comboYear(new ComboBox(this)),
       m_comboSeason(new ComboBox(this)),
       m_comboType(new ComboBox(this)),
-      m_comboStatus(new ComboBox(this)) {
+      m_comboStatus(new ComboBox(this)),
+      m_seasonTimer(new QTimer(this)) {
   m_proxyModel->sort(taiga::session.searchListSortColumn(), taiga::session.searchListSortOrder());
   m_proxyModel->setFilters(taiga::session.searchListFilters());
 
@@ -47,6 +50,19 @@ SearchWidget::SearchWidget(QWidget* parent)
     return index > -1 ? std::optional<int>{combo->itemData(index).toInt()} : std::nullopt;
   };
 
+  // Items of a season are fetched once both the year and the season are known,
+  // and the selection has settled, so that browsing through the years does not
+  // request each season along the way.
+  m_seasonTimer->setSingleShot(true);
+  m_seasonTimer->setInterval(std::chrono::milliseconds{500});
+  connect(m_seasonTimer, &QTimer::timeout, this, [this]() {
+    const auto& filters = m_proxyModel->filters();
+    if (!filters.year || !filters.season) return;
+    sync::fetchSeason(anime::Season{static_cast<anime::SeasonName>(*filters.season),
+                                    std::chrono::year{*filters.year}});
+  });
+  const auto fetchSeason = [this]() { m_seasonTimer->start(); };
+
   auto filtersLayout = new QHBoxLayout(this);
   filtersLayout->setSpacing(4);
   m_toolbarLayout->insertLayout(0, filtersLayout);
@@ -60,8 +76,10 @@ SearchWidget::SearchWidget(QWidget* parent)
     if (m_proxyModel->filters().year) {
       m_comboYear->setCurrentText(QString::number(*m_proxyModel->filters().year));
     }
-    connect(m_comboYear, &QComboBox::currentIndexChanged, this,
-            [this](int index) { m_proxyModel->setYearFilter(filterValue(m_comboYear, index)); });
+    connect(m_comboYear, &QComboBox::currentIndexChanged, this, [this, fetchSeason](int index) {
+      m_proxyModel->setYearFilter(filterValue(m_comboYear, index));
+      fetchSeason();
+    });
     filtersLayout->addWidget(m_comboYear);
   }
 
@@ -81,8 +99,9 @@ SearchWidget::SearchWidget(QWidget* parent)
       m_comboSeason->setCurrentText(
           formatSeasonName(static_cast<anime::SeasonName>(*m_proxyModel->filters().season)));
     }
-    connect(m_comboSeason, &QComboBox::currentIndexChanged, this, [this](int index) {
+    connect(m_comboSeason, &QComboBox::currentIndexChanged, this, [this, fetchSeason](int index) {
       m_proxyModel->setSeasonFilter(filterValue(m_comboSeason, index));
+      fetchSeason();
     });
     filtersLayout->addWidget(m_comboSeason);
   }
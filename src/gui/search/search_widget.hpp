@@ -22,6 +22,8 @@
 #include "gui/common/combobox.hpp"
 #include "gui/common/page_widget.hpp"
 
+class QTimer;
+
 namespace gui {
 
 class AnimeListModel;
@@ -45,6 +47,7 @@ private:
   ComboBox* m_comboSeason = nullptr;
   ComboBox* m_comboType = nullptr;
   ComboBox* m_comboStatus = nullptr;
+  QTimer* m_seasonTimer = nullptr;
   ListViewCards* m_listViewCards = nullptr;
   ListViewMode m_viewMode = ListViewMode::Cards;
 };
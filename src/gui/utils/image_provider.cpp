@@ -19,18 +19,32 @@
 #include "image_provider.hpp"
 
 #include <QFile>
+#include <QGuiApplication>
 #include <QImage>
 #include <QImageReader>
 #include <QNetworkReply>
 #include <QNetworkRequest>
+#include <QThreadPool>
 
 #include "base/string.hpp"
 #include "media/anime_db.hpp"
 #include "taiga/network.hpp"
 #include "taiga/path.hpp"
+#include "taiga/settings.hpp"
 
 namespace gui {
 
+namespace {
+
+// Decoding is mostly limited by the disk, and should not hold up other work
+constexpr int kMaxConcurrentDecodes = 2;
+
+}  // namespace
+
+ImageProvider::ImageProvider() {
+  m_pool.setMaxThreadCount(kMaxConcurrentDecodes);
+}
+
 void ImageProvider::fetchPoster(const int id) {
   const auto item = anime::db.item(id);
 
@@ -40,6 +54,7 @@ void ImageProvider::fetchPoster(const int id) {
   const auto reply = taiga::network()->get(QNetworkRequest{url});
 
   connect(reply, &QNetworkReply::finished, this, [this, id, reply]() {
+    if (reply->error() != QNetworkReply::NoError) return;
     QFile file{fileName(id)};
     if (!file.open(QIODevice::WriteOnly)) return;
     file.write(reply->readAll());
@@ -47,27 +62,118 @@ void ImageProvider::fetchPoster(const int id) {
   });
 }
 
-const QPixmap* ImageProvider::loadPoster(const int id) {
-  if (const auto it = m_pixmaps.find(id); it != m_pixmaps.end()) {
-    return &it.value();
+const QPixmap* ImageProvider::loadPoster(const int id, const PosterSize size) {
+  if (const auto pixmap = findPoster({id, size})) {
+    ++m_cacheStats.hits;
+    return pixmap;
   }
 
-  QImageReader reader(fileName(id));
-  const QImage image = reader.read();
-
-  m_pixmaps[id] = !image.isNull() ? QPixmap::fromImage(image) : QPixmap{};
+  // Full-size posters can be displayed as thumbnails as well
+  if (size == PosterSize::Thumbnail) {
+    if (const auto pixmap = findPoster({id, PosterSize::Full})) {
+      ++m_cacheStats.hits;
+      return pixmap;
+    }
+  }
 
-  if (image.isNull()) fetchPoster(id);
+  // Posters that could not be read are fetched, and then reloaded
+  if (!m_missing.contains(id) && !m_decoding.contains({id, size})) {
+    ++m_cacheStats.misses;
+    decodePoster({id, size});
+  }
 
-  return &m_pixmaps[id];
+  return &m_placeholder;
 }
 
+// Decodes that are still running belong to the previous file, and their results
+// are discarded.
 void ImageProvider::reloadPoster(const int id) {
-  m_pixmaps.remove(id);
-  loadPoster(id);
+  ++m_generations[id];
+  m_decoding.remove({id, PosterSize::Thumbnail});
+  m_decoding.remove({id, PosterSize::Full});
+  m_missing.remove(id);
+  m_posters.remove({id, PosterSize::Thumbnail});
+  m_posters.remove({id, PosterSize::Full});
+  if (m_oversizedKey.id == id) m_oversized = {};
   emit posterChanged(id);
 }
 
+const ImageProvider::CacheStats& ImageProvider::cacheStats() const {
+  return m_cacheStats;
+}
+
+qsizetype ImageProvider::cacheSize() const {
+  return m_posters.totalCost();
+}
+
+void ImageProvider::decodePoster(const PosterKey& key) {
+  m_decoding.insert(key);
+
+  const auto size =
+      (key.size == PosterSize::Thumbnail ? kPosterThumbnailSize : kPosterFullSize) *
+      qGuiApp->devicePixelRatio();
+
+  m_pool.start([this, key, size, generation = m_generations.value(key.id),
+                path = fileName(key.id)]() {
+    QImageReader reader(path);
+
+    // Posters are cropped to fill their area, so they are scaled to cover it
+    if (const auto original = reader.size(); size.isValid() && original.isValid()) {
+      const auto scaled = original.scaled(size, Qt::KeepAspectRatioByExpanding);
+      if (scaled.width() < original.width()) reader.setScaledSize(scaled);
+    }
+
+    const QImage image = reader.read();
+
+    QMetaObject::invokeMethod(
+        this, [this, key, generation, image]() { setPoster(key, generation, image); },
+        Qt::QueuedConnection);
+  });
+}
+
+void ImageProvider::setPoster(const PosterKey& key, const int generation, const QImage& image) {
+  if (generation != m_generations.value(key.id)) return;
+
+  m_decoding.remove(key);
+
+  if (image.isNull()) {
+    if (m_missing.contains(key.id)) return;
+    m_missing.insert(key.id);
+    fetchPoster(key.id);
+    return;
+  }
+
+  // The budget is read each time, so that changes to it apply right away.
+  // Posters that no longer fit into a smaller budget are discarded.
+  const auto previousCount = m_posters.size();
+  m_posters.setMaxCost(qsizetype{taiga::settings.posterCacheSize()} * 1024 * 1024);
+  m_cacheStats.evictions += previousCount - m_posters.size();
+
+  // The cache would refuse the poster, and it would be decoded over and over
+  if (image.sizeInBytes() > m_posters.maxCost()) {
+    m_posters.remove(key);
+    if (!m_oversized.isNull() && m_oversizedKey != key) ++m_cacheStats.evictions;
+    m_oversizedKey = key;
+    m_oversized = QPixmap::fromImage(image);
+    emit posterChanged(key.id);
+    return;
+  }
+
+  if (m_oversizedKey == key) m_oversized = {};
+
+  const auto count = m_posters.size() + (m_posters.contains(key) ? 0 : 1);
+  if (!m_posters.insert(key, new QPixmap(QPixmap::fromImage(image)), image.sizeInBytes())) return;
+  m_cacheStats.evictions += count - m_posters.size();
+
+  emit posterChanged(key.id);
+}
+
+const QPixmap* ImageProvider::findPoster(const PosterKey& key) {
+  if (const auto pixmap = m_posters.object(key)) return pixmap;
+  if (!m_oversized.isNull() && m_oversizedKey == key) return &m_oversized;
+  return nullptr;
+}
+
 QString ImageProvider::fileName(const int id) const {
   const auto path = QString::fromStdString(taiga::get_data_path());
   return u"%1/v1/db/image/%2.jpg"_s.arg(path).arg(id);  // @TODO: Support other formats (#1191)
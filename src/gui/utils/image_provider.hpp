@@ -18,31 +18,86 @@
 
 #pragma once
 
-#include <QMap>
+#include <QCache>
+#include <QHash>
+#include <QHashFunctions>
+#include <QImage>
 #include <QObject>
 #include <QPixmap>
+#include <QSet>
+#include <QSize>
 #include <QString>
+#include <QThreadPool>
 
 namespace gui {
 
+enum class PosterSize {
+  Thumbnail,
+  Full,
+};
+
+// Size of the posters on cards, in device-independent pixels
+constexpr QSize kPosterThumbnailSize{140, 210};
+// Largest size of the poster in the media dialog
+constexpr QSize kPosterFullSize{320, 480};
+
+// Posters are decoded in the background, at the size they are displayed at.
+// Until they are ready, an empty pixmap is returned and `posterChanged` is
+// emitted once they are.
+//
+// Decoded posters are kept within a memory budget, and those that were least
+// recently used are discarded first. A poster that is larger than the whole
+// budget is kept aside until another one takes its place.
 class ImageProvider final : public QObject {
   Q_OBJECT
   Q_DISABLE_COPY_MOVE(ImageProvider)
 
 public:
-  ImageProvider() = default;
+  struct CacheStats {
+    int hits = 0;
+    int misses = 0;
+    int evictions = 0;
+  };
+
+  ImageProvider();
 
   void fetchPoster(const int id);
-  const QPixmap* loadPoster(const int id);
+  const QPixmap* loadPoster(const int id, const PosterSize size = PosterSize::Full);
   void reloadPoster(const int id);
 
+  const CacheStats& cacheStats() const;
+  qsizetype cacheSize() const;
+
 signals:
   void posterChanged(const int id);
 
 private:
+  struct PosterKey {
+    int id = 0;
+    PosterSize size = PosterSize::Full;
+
+    bool operator==(const PosterKey& key) const = default;
+
+    friend size_t qHash(const PosterKey& key, size_t seed = 0) {
+      return qHashMulti(seed, key.id, static_cast<int>(key.size));
+    }
+  };
+
+  void decodePoster(const PosterKey& key);
+  void setPoster(const PosterKey& key, const int generation, const QImage& image);
+  const QPixmap* findPoster(const PosterKey& key);
+
   QString fileName(const int id) const;
 
-  QMap<int, QPixmap> m_pixmaps;
+  QCache<PosterKey, QPixmap> m_posters;
+  PosterKey m_oversizedKey;
+  QPixmap m_oversized;
+  QSet<PosterKey> m_decoding;
+  QSet<int> m_missing;
+  QHash<int, int> m_generations;
+  QThreadPool m_pool;
+  CacheStats m_cacheStats;
+  const QPixmap m_placeholder;
 };
 
 inline ImageProvider imageProvider;
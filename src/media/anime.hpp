@@ -19,6 +19,7 @@
 #pragma once
 
 #include <array>
+#include <map>
 #include <string>
 #include <vector>
 
@@ -88,7 +89,7 @@ struct Titles {
 
 struct Details {
   int id = kUnknownId;
-  // std::map<sync::ServiceId, std::string> uids;
+  std::map<std::string, int> uids;  // by service slug
   // sync::ServiceId source = sync::ServiceId::Unknown;
   std::time_t last_modified = 0;
   int episode_count = kUnknownEpisodeCount;
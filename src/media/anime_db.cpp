@@ -23,9 +23,12 @@
 #include <QSqlQuery>
 #include <QSqlRecord>
 #include <QSqlResult>
+#include <algorithm>
+#include <array>
 #include <format>
 
 #include "base/file.hpp"
+#include "base/log.hpp"
 #include "base/string.hpp"
 #include "compat/anime.hpp"
 #include "compat/list.hpp"
@@ -36,21 +39,42 @@
 
 namespace anime {
 
+namespace {
+
+// Columns of the ID mapping table, named after service slugs
+constexpr std::array<const char*, 3> kServices{"anilist", "kitsu", "myanimelist"};
+
+}  // namespace
+
 Database::Database() : QObject{} {}
 
 void Database::init() {
   db_ = QSqlDatabase::addDatabase("QSQLITE");
   db_.setDatabaseName(fileName());
 
+  const auto service = taiga::settings.service();
+
   if (!QFile::exists(fileName())) {
     createTables();
     migrateItemsFromV1();
     migrateListEntriesFromV1();
+    setMetaValue("service", QString::fromStdString(service));
     return;
   }
 
+  // Tables that were added in later versions
+  createTables();
+
   readItems();
+  readIds();
   readEntries();
+  readQueue();
+
+  // Our data is keyed by the IDs of the service that it came from
+  const auto previous = metaValue("service").toStdString();
+  if (previous == service) return;
+  if (!previous.empty()) rekey(previous, service);
+  setMetaValue("service", QString::fromStdString(service));
 }
 
 const Anime* Database::item(const int id) const {
@@ -71,14 +95,25 @@ const QMap<int, ListEntry>& Database::entries() const {
   return entries_;
 }
 
-void Database::updateItem(const Anime& item) {
+void Database::updateItem(const Anime& updated) {
+  Anime item = updated;
+  mergeIds(item);
+
   if (!db_.open()) return;
 
+  db_.transaction();
+
   QSqlQuery q{db_};
-  if (!q.prepare(sql("insertAnime"))) return;
-  bindItemToQuery(item, q);
-  q.exec();
+  if (q.prepare(sql("insertAnime"))) {
+    bindItemToQuery(item, q);
+    q.exec();
+  }
+  if (q.prepare(sql("insertMediaIds"))) {
+    bindIdsToQuery(item, q);
+    q.exec();
+  }
 
+  db_.commit();
   db_.close();
 
   items_[item.id] = item;
@@ -101,6 +136,107 @@ void Database::updateEntry(const ListEntry& entry) {
   emit entryUpdated(entry.anime_id);
 }
 
+void Database::updateList(const QList<Anime>& items, const QList<ListEntry>& entries) {
+  applyList(items, entries, true);
+}
+
+void Database::mergeList(const QList<Anime>& items, const QList<ListEntry>& entries) {
+  applyList(items, entries, false);
+}
+
+const QMap<int, ListEntry>& Database::queuedEntries() const {
+  return queue_;
+}
+
+// Consecutive changes to the same entry replace each other, so that only the
+// latest state is sent.
+void Database::queueEntry(const ListEntry& entry) {
+  if (!db_.open()) return;
+
+  db_.transaction();
+
+  QSqlQuery q{db_};
+  if (q.prepare(sql("insertAnimeList"))) {
+    bindEntryToQuery(entry, q);
+    q.exec();
+  }
+  if (q.prepare(sql("insertListQueue"))) {
+    bindEntryToQuery(entry, q);
+    q.exec();
+  }
+
+  db_.commit();
+  db_.close();
+
+  entries_[entry.anime_id] = entry;
+  queue_[entry.anime_id] = entry;
+
+  emit entryUpdated(entry.anime_id);
+  emit entryQueued(entry.anime_id);
+}
+
+// Entries that were changed again after being sent remain in the queue
+void Database::dequeueEntry(const ListEntry& sent, const ListEntry& saved) {
+  if (const auto it = queue_.find(sent.anime_id); it == queue_.end() || *it != sent) return;
+
+  if (!db_.open()) return;
+
+  db_.transaction();
+
+  QSqlQuery q{db_};
+  q.prepare("DELETE FROM list_queue WHERE media_id = :media_id");
+  q.bindValue(":media_id", sent.anime_id);
+  q.exec();
+  // New entries are only given an ID by the service
+  q.prepare("DELETE FROM anime_list WHERE media_id = :media_id");
+  q.bindValue(":media_id", sent.anime_id);
+  q.exec();
+  if (q.prepare(sql("insertAnimeList"))) {
+    bindEntryToQuery(saved, q);
+    q.exec();
+  }
+
+  db_.commit();
+  db_.close();
+
+  queue_.remove(sent.anime_id);
+  entries_[saved.anime_id] = saved;
+
+  emit entryUpdated(saved.anime_id);
+}
+
+QString Database::metaValue(const QString& name) {
+  if (!db_.open()) return {};
+
+  QSqlQuery q{db_};
+  q.prepare("SELECT value FROM meta WHERE name = :name");
+  q.bindValue(":name", name);
+  q.exec();
+  const QString value = q.next() ? q.value(0).toString() : QString{};
+
+  db_.close();
+
+  return value;
+}
+
+void Database::setMetaValue(const QString& name, const QString& value) {
+  if (!db_.open()) return;
+
+  db_.transaction();
+
+  QSqlQuery q{db_};
+  q.prepare("DELETE FROM meta WHERE name = :name");
+  q.bindValue(":name", name);
+  q.exec();
+  q.prepare("INSERT INTO meta(name, value) VALUES(:name, :value)");
+  q.bindValue(":name", name);
+  q.bindValue(":value", value);
+  q.exec();
+
+  db_.commit();
+  db_.close();
+}
+
 QString Database::fileName() const {
   return u"%1/media.sqlite"_s.arg(QString::fromStdString(taiga::get_data_path()));
 }
@@ -135,6 +271,21 @@ void Database::createTables() {
     q.exec(sql("createAnimeList"));
   }
 
+  if (!tables.contains("list_queue")) {
+    QSqlQuery q{db_};
+    q.exec(sql("createListQueue"));
+  }
+
+  if (!tables.contains("list_queue_held")) {
+    QSqlQuery q{db_};
+    q.exec(sql("createListQueueHeld"));
+  }
+
+  if (!tables.contains("media_ids")) {
+    QSqlQuery q{db_};
+    q.exec(sql("createMediaIds"));
+  }
+
   db_.commit();
   db_.close();
 }
@@ -183,6 +334,257 @@ void Database::readEntries() {
   db_.close();
 }
 
+// Writes the given items, and only the entries that differ from ours, in a
+// single transaction. When the list is complete, entries that are missing from
+// it are removed.
+void Database::applyList(const QList<Anime>& updated, const QList<ListEntry>& entries,
+                         const bool isComplete) {
+  QList<Anime> items = updated;
+  for (auto& item : items) {
+    mergeIds(item);
+  }
+
+  // Queued changes take precedence over what the service has
+  QMap<int, ListEntry> incoming;
+  for (const auto& entry : entries) {
+    incoming[entry.anime_id] = queue_.value(entry.anime_id, entry);
+  }
+
+  QList<int> added;
+  QList<int> changed;
+  QList<int> removed;
+
+  // Both maps are sorted by ID, so they can be compared in a single pass
+  auto a = entries_.cbegin();
+  auto b = incoming.cbegin();
+  while (a != entries_.cend() || b != incoming.cend()) {
+    if (b == incoming.cend() || (a != entries_.cend() && a.key() < b.key())) {
+      if (isComplete && !queue_.contains(a.key())) removed.push_back(a.key());
+      ++a;
+    } else if (a == entries_.cend() || b.key() < a.key()) {
+      added.push_back(b.key());
+      ++b;
+    } else {
+      if (a.value() != b.value()) changed.push_back(b.key());
+      ++a;
+      ++b;
+    }
+  }
+
+  if (items.isEmpty() && added.isEmpty() && changed.isEmpty() && removed.isEmpty()) return;
+
+  if (!db_.open()) return;
+
+  const bool hasNewItems =
+      std::ranges::any_of(items, [this](const Anime& item) { return !items_.contains(item.id); });
+
+  db_.transaction();
+
+  {
+    QSqlQuery q{db_};
+    if (q.prepare(sql("insertAnime"))) {
+      for (const auto& item : items) {
+        bindItemToQuery(item, q);
+        q.exec();
+      }
+    }
+    if (q.prepare(sql("insertMediaIds"))) {
+      for (const auto& item : items) {
+        bindIdsToQuery(item, q);
+        q.exec();
+      }
+    }
+  }
+
+  {
+    QSqlQuery q{db_};
+    // Entries are keyed by their ID on the service, which changes when the
+    // service does, so they are replaced rather than updated
+    if (q.prepare("DELETE FROM anime_list WHERE media_id = :media_id")) {
+      for (const auto id : removed + changed) {
+        q.bindValue(":media_id", id);
+        q.exec();
+      }
+    }
+    if (q.prepare(sql("insertAnimeList"))) {
+      for (const auto id : added + changed) {
+        bindEntryToQuery(incoming[id], q);
+        q.exec();
+      }
+    }
+  }
+
+  db_.commit();
+  db_.close();
+
+  for (const auto& item : items) {
+    items_[item.id] = item;
+  }
+  for (const auto id : removed) {
+    entries_.remove(id);
+  }
+  for (const auto id : added + changed) {
+    entries_[id] = incoming[id];
+  }
+
+  // Views are reset once when rows come and go, rather than once per row
+  if (hasNewItems || !added.isEmpty() || !removed.isEmpty()) {
+    emit listUpdated();
+    return;
+  }
+
+  for (const auto& item : items) {
+    emit itemUpdated(item.id);
+  }
+  for (const auto id : changed) {
+    emit entryUpdated(id);
+  }
+}
+
+void Database::readQueue() {
+  if (!db_.open()) return;
+
+  QSqlQuery q{db_};
+  if (!q.exec("SELECT * FROM list_queue")) return;
+
+  while (q.next()) {
+    const int id = q.value("media_id").toInt();
+    queue_[id] = entryFromQuery(q);
+  }
+
+  db_.close();
+}
+
+void Database::readIds() {
+  if (!db_.open()) return;
+
+  QSqlQuery q{db_};
+  if (!q.exec("SELECT * FROM media_ids")) return;
+
+  while (q.next()) {
+    const auto it = items_.find(q.value("media_id").toInt());
+    if (it == items_.end()) continue;
+    for (const auto service : kServices) {
+      if (const int id = q.value(service).toInt()) it->uids[service] = id;
+    }
+  }
+
+  db_.close();
+}
+
+// IDs that we already know of are kept, as services only tell us about some
+void Database::mergeIds(Anime& item) const {
+  item.uids[taiga::settings.service()] = item.id;
+  if (const auto it = items_.find(item.id); it != items_.end()) {
+    item.uids.insert(it->uids.begin(), it->uids.end());
+  }
+}
+
+// Moves our data over to the IDs of another service, so that it does not have
+// to be downloaded again. Items that cannot be mapped are left out, to be
+// fetched with the next synchronization.
+// Queued changes to items that have no ID on the new service are held back
+// rather than discarded, and are queued again when the previous service is
+// selected.
+void Database::rekey(const std::string& from, const std::string& to) {
+  QMap<int, Anime> items;
+  QMap<int, ListEntry> entries;
+  QMap<int, ListEntry> queue;
+  QMap<int, ListEntry> held = queue_;
+
+  for (auto item : items_) {
+    item.uids[from] = item.id;
+    const auto it = item.uids.find(to);
+    if (it == item.uids.end() || it->second == kUnknownId) continue;
+    const int id = it->second;
+
+    // Entry IDs are replaced by those of the new service when synchronized
+    if (const auto entry = entries_.constFind(item.id); entry != entries_.cend()) {
+      entries[id] = *entry;
+      entries[id].id = list::kUnknownId;
+      entries[id].anime_id = id;
+    }
+    if (const auto entry = held.constFind(item.id); entry != held.cend()) {
+      queue[id] = *entry;
+      queue[id].id = list::kUnknownId;
+      queue[id].anime_id = id;
+      held.erase(entry);
+    }
+
+    item.id = id;
+    items[id] = item;
+  }
+
+  if (!db_.open()) return;
+
+  db_.transaction();
+
+  {
+    QSqlQuery q{db_};
+
+    q.prepare("SELECT * FROM list_queue_held WHERE service = :service");
+    q.bindValue(":service", QString::fromStdString(to));
+    if (q.exec()) {
+      while (q.next()) {
+        const auto entry = entryFromQuery(q);
+        if (!queue.contains(entry.anime_id)) queue[entry.anime_id] = entry;
+      }
+    }
+    q.prepare("DELETE FROM list_queue_held WHERE service = :service");
+    q.bindValue(":service", QString::fromStdString(to));
+    q.exec();
+
+    for (const auto table : {"anime", "anime_list", "list_queue", "media_ids"}) {
+      q.exec(u"DELETE FROM %1"_s.arg(QLatin1StringView{table}));
+    }
+    if (q.prepare(sql("insertAnime"))) {
+      for (const auto& item : items) {
+        bindItemToQuery(item, q);
+        q.exec();
+      }
+    }
+    if (q.prepare(sql("insertMediaIds"))) {
+      for (const auto& item : items) {
+        bindIdsToQuery(item, q);
+        q.exec();
+      }
+    }
+    if (q.prepare(sql("insertAnimeList"))) {
+      for (const auto& entry : entries) {
+        bindEntryToQuery(entry, q);
+        q.exec();
+      }
+    }
+    if (q.prepare(sql("insertListQueue"))) {
+      for (const auto& entry : queue) {
+        bindEntryToQuery(entry, q);
+        q.exec();
+      }
+    }
+    if (q.prepare(sql("insertListQueueHeld"))) {
+      for (const auto& entry : held) {
+        bindEntryToQuery(entry, q);
+        q.bindValue(":service", QString::fromStdString(from));
+        q.exec();
+      }
+    }
+  }
+
+  db_.commit();
+  db_.close();
+
+  LOGI("Moved {} of {} items from {} to {}.", items.size(), items_.size(), from, to);
+
+  if (!held.isEmpty()) {
+    LOGW("Held back {} queued changes that could not be moved from {} to {}.", held.size(), from,
+         to);
+  }
+
+  items_ = std::move(items);
+  entries_ = std::move(entries);
+  queue_ = std::move(queue);
+}
+
 void Database::bindItemToQuery(const Anime& item, QSqlQuery& q) const {
   q.bindValue(":id", item.id);
   q.bindValue(":title", QString::fromStdString(item.titles.romaji));
@@ -210,8 +612,10 @@ void Database::bindItemToQuery(const Anime& item, QSqlQuery& q) const {
   q.bindValue(":modified", QString::number(item.last_modified));
 }
 
+// Entries that are not known to the service yet are stored under the negated
+// media ID, because the list table is keyed by entry IDs.
 void Database::bindEntryToQuery(const ListEntry& entry, QSqlQuery& q) const {
-  q.bindValue(":id", entry.id);
+  q.bindValue(":id", entry.id != list::kUnknownId ? entry.id : -entry.anime_id);
   q.bindValue(":media_id", entry.anime_id);
   q.bindValue(":progress", entry.watched_episodes);
   q.bindValue(":date_start", QString::fromStdString(entry.date_started.to_string()));
@@ -226,6 +630,15 @@ void Database::bindEntryToQuery(const ListEntry& entry, QSqlQuery& q) const {
   q.bindValue(":last_updated", QString::number(entry.last_updated));
 }
 
+void Database::bindIdsToQuery(const Anime& item, QSqlQuery& q) const {
+  q.bindValue(":media_id", item.id);
+  for (const auto service : kServices) {
+    const auto it = item.uids.find(service);
+    const auto id = it != item.uids.end() ? QVariant{it->second} : QVariant{};
+    q.bindValue(u":%1"_s.arg(QLatin1StringView{service}), id);
+  }
+}
+
 Anime Database::itemFromQuery(const QSqlQuery& q) const {
   static const auto splitToVector = [](const QVariant& variant) {
     return toVector(variant.toString().split(", ", Qt::SkipEmptyParts));
@@ -262,7 +675,7 @@ Anime Database::itemFromQuery(const QSqlQuery& q) const {
 
 ListEntry Database::entryFromQuery(const QSqlQuery& q) const {
   return {
-      .id = q.value("id").toLongLong(),
+      .id = std::max(q.value("id").toLongLong(), qint64{list::kUnknownId}),
       .anime_id = q.value("media_id").toInt(),
       .watched_episodes = q.value("progress").toInt(),
       .score = q.value("score").toInt(),
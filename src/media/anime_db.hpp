@@ -45,10 +45,22 @@ public:
 
   void updateItem(const Anime& item);
   void updateEntry(const ListEntry& entry);
+  void updateList(const QList<Anime>& items, const QList<ListEntry>& entries);
+  void mergeList(const QList<Anime>& items, const QList<ListEntry>& entries);
+
+  // Changes to the list that are yet to be sent to the service
+  const QMap<int, ListEntry>& queuedEntries() const;
+  void queueEntry(const ListEntry& entry);
+  void dequeueEntry(const ListEntry& sent, const ListEntry& saved);
+
+  QString metaValue(const QString& name);
+  void setMetaValue(const QString& name, const QString& value);
 
 signals:
   void itemUpdated(const int id);
   void entryUpdated(const int id);
+  void listUpdated();
+  void entryQueued(const int id);
 
 private:
   QString fileName() const;
@@ -59,9 +71,18 @@ private:
 
   void readItems();
   void readEntries();
+  void readQueue();
+  void readIds();
+
+  void mergeIds(Anime& item) const;
+  void rekey(const std::string& from, const std::string& to);
+
+  void applyList(const QList<Anime>& items, const QList<ListEntry>& entries,
+                 const bool isComplete);
 
   void bindItemToQuery(const Anime& item, QSqlQuery& q) const;
   void bindEntryToQuery(const ListEntry& entry, QSqlQuery& q) const;
+  void bindIdsToQuery(const Anime& item, QSqlQuery& q) const;
 
   Anime itemFromQuery(const QSqlQuery& q) const;
   ListEntry entryFromQuery(const QSqlQuery& q) const;
@@ -73,6 +94,7 @@ private:
 
   QMap<int, Anime> items_;
   QMap<int, ListEntry> entries_;
+  QMap<int, ListEntry> queue_;
 };
 
 inline Database db;
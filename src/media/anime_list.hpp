@@ -61,6 +61,8 @@ struct Entry {
   FuzzyDate date_completed;
   std::time_t last_updated;
   std::string notes;
+
+  bool operator==(const Entry& entry) const = default;
 };
 
 }  // namespace anime::list
@@ -0,0 +1,7 @@
+CREATE TABLE IF NOT EXISTS library_entry(
+  folder TEXT NOT NULL,
+  name TEXT NOT NULL,
+  directory INTEGER,
+  PRIMARY KEY (folder, name),
+  FOREIGN KEY (folder) REFERENCES library_folder (path)
+);
@@ -0,0 +1,5 @@
+CREATE TABLE IF NOT EXISTS library_folder(
+  path TEXT PRIMARY KEY,
+  last_modified INTEGER,
+  crawl INTEGER
+);
@@ -0,0 +1,15 @@
+CREATE TABLE IF NOT EXISTS list_queue(
+  media_id INTEGER PRIMARY KEY,
+  id INTEGER,
+  progress INTEGER,
+  date_start TEXT,
+  date_end TEXT,
+  score INTEGER,
+  status INTEGER,
+  private INTEGER,
+  rewatched_times INTEGER,
+  rewatching INTEGER,
+  rewatching_ep INTEGER,
+  notes TEXT,
+  last_updated TEXT
+);
@@ -0,0 +1,17 @@
+CREATE TABLE IF NOT EXISTS list_queue_held(
+  service TEXT NOT NULL,
+  media_id INTEGER NOT NULL,
+  id INTEGER,
+  progress INTEGER,
+  date_start TEXT,
+  date_end TEXT,
+  score INTEGER,
+  status INTEGER,
+  private INTEGER,
+  rewatched_times INTEGER,
+  rewatching INTEGER,
+  rewatching_ep INTEGER,
+  notes TEXT,
+  last_updated TEXT,
+  PRIMARY KEY (service, media_id)
+);
@@ -0,0 +1,7 @@
+CREATE TABLE IF NOT EXISTS media_ids(
+  media_id INTEGER PRIMARY KEY,
+  anilist INTEGER,
+  kitsu INTEGER,
+  myanimelist INTEGER,
+  FOREIGN KEY (media_id) REFERENCES media (id)
+);
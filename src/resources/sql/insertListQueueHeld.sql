@@ -0,0 +1,33 @@
+INSERT OR REPLACE INTO
+  list_queue_held(
+    service,
+    id,
+    media_id,
+    progress,
+    date_start,
+    date_end,
+    score,
+    status,
+    private,
+    rewatched_times,
+    rewatching,
+    rewatching_ep,
+    notes,
+    last_updated
+  )
+  VALUES(
+    :service,
+    :id,
+    :media_id,
+    :progress,
+    :date_start,
+    :date_end,
+    :score,
+    :status,
+    :private,
+    :rewatched_times,
+    :rewatching,
+    :rewatching_ep,
+    :notes,
+    :last_updated
+  )
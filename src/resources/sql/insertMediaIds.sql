@@ -0,0 +1,13 @@
+INSERT OR REPLACE INTO
+  media_ids(
+    media_id,
+    anilist,
+    kitsu,
+    myanimelist
+  )
+  VALUES(
+    :media_id,
+    :anilist,
+    :kitsu,
+    :myanimelist
+  )
@@ -18,10 +18,15 @@
 
 #include "anilist.hpp"
 
+#include <QDateTime>
 #include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonObject>
+#include <QNetworkReply>
 #include <QRestReply>
+#include <QStringList>
+#include <QTimer>
+#include <memory>
 #include <ranges>
 
 #include "base/file.hpp"
@@ -31,14 +36,63 @@
 #include "sync/anilist_parsers.hpp"
 #include "sync/anilist_utils.hpp"
 #include "taiga/accounts.hpp"
+#include "taiga/network.hpp"
+#include "taiga/settings.hpp"
 
 // AniList API documentation:
 // https://docs.anilist.co/
 
 namespace sync::anilist {
 
-Service::Service() : sync::Service{} {
-  api_.setBaseUrl(QUrl{"https://graphql.anilist.co"});
+namespace {
+
+// Requests for single items are collected for a short while, then fetched
+// together, up to the number of items that fits in a page.
+constexpr auto kFetchDelay = std::chrono::milliseconds{100};
+constexpr int kMaxPerPage = 50;
+
+// Searches that match more items than this are not worth going through
+constexpr int kMaxPages = 20;
+
+// Seasons that were requested recently, including those still in flight, are
+// not requested again
+constexpr auto kSeasonFetchInterval = std::chrono::minutes{10};
+
+// Each mutation adds to the complexity of a request, which is limited
+constexpr int kMaxSavePerRequest = 10;
+
+// Cover images are served from here
+constexpr auto kImageHost = "https://s4.anilist.co";
+
+// Requests per minute, as documented. Actual limits are read from responses.
+constexpr int kRateLimit = 90;
+
+// Entries that were updated after the newest one we have are fetched by
+// themselves. The complete list is fetched every once in a while.
+constexpr auto kListUpdatedAt = "anilist.list.updated_at";
+constexpr auto kListSyncedAt = "anilist.list.synced_at";
+constexpr auto kFullSyncInterval = std::chrono::seconds{std::chrono::days{7}};
+
+std::time_t lastUpdated(const QList<ListEntry>& entries) {
+  std::time_t value = 0;
+  for (const auto& entry : entries) {
+    value = std::max(value, entry.last_updated);
+  }
+  return value;
+}
+
+}  // namespace
+
+Service::Service() : sync::Service{ServiceId::AniList}, fetch_timer_{new QTimer(this)} {
+  api_.setBaseUrl(QUrl{QString::fromStdString(taiga::settings.anilistApiUrl())});
+  scheduler_->setRateLimit(kRateLimit);
+
+  fetch_timer_->setSingleShot(true);
+  fetch_timer_->setInterval(kFetchDelay);
+  connect(fetch_timer_, &QTimer::timeout, this, &Service::fetchPendingAnime);
+
+  // A single thread keeps the chunks of a response in order
+  parse_pool_.setMaxThreadCount(1);
 
   if (const auto token = taiga::accounts.anilistToken(); !token.empty()) {
     api_.setBearerToken(QByteArray::fromStdString(token));
@@ -52,6 +106,11 @@ Service* Service::instance() {
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void Service::preconnect() {
+  taiga::network()->preconnect(api_.baseUrl());
+  taiga::network()->preconnect(QUrl{kImageHost});
+}
+
 void Service::authenticateUser() {
   const QJsonDocument data{QJsonObject{
       {"query", gql("Viewer")},
@@ -80,73 +139,290 @@ void Service::authenticateUser() {
     // @TODO: Set authenticated state and emit signal
   };
 
-  manager_.post(api_.createRequest(), data, this, callback);
+  scheduler_->post("Viewer", api_.createRequest(), data, Priority::User, callback);
 }
 
 void Service::fetchAnime(const int id) {
+  if (pending_ids_.contains(id) || fetching_ids_.contains(id)) return;
+
+  pending_ids_.insert(id);
+
+  if (!fetch_timer_->isActive()) fetch_timer_->start();
+}
+
+void Service::fetchPendingAnime() {
+  const auto ids = std::exchange(pending_ids_, {}).values();
+
+  for (const auto batch : ids | std::views::chunk(kMaxPerPage)) {
+    fetchAnimePage(batch | std::ranges::to<QList>());
+  }
+}
+
+// Unlike `fetchAnime`, these are sent right away, behind any other requests
+void Service::refreshAnime(const QList<int>& ids) {
+  const auto ready = ids | std::views::filter([this](const int id) {
+                       return !pending_ids_.contains(id) && !fetching_ids_.contains(id);
+                     }) |
+                     std::ranges::to<QList>();
+
+  for (const auto batch : ready | std::views::chunk(kMaxPerPage)) {
+    fetchAnimePage(batch | std::ranges::to<QList>(), Priority::Background);
+  }
+}
+
+void Service::fetchAnimePage(const QList<int>& ids, const Priority priority) {
+  QJsonArray array;
+
+  for (const auto id : ids) {
+    array.append(id);
+    fetching_ids_.insert(id);
+  }
+
   const QJsonDocument data{{
-      {"query", gql("Media")},
-      {"variables", QJsonObject{{"id", id}}},
+      {"query", gql("MediaPage")},
+      {"variables", QJsonObject{{"ids", array}, {"perPage", kMaxPerPage}}},
   }};
 
-  const auto callback = [this](QRestReply& reply) {
+  const auto callback = [this, ids](QRestReply& reply) {
+    for (const auto id : ids) {
+      fetching_ids_.remove(id);
+    }
+
     if (isError(reply)) {
       handleError(reply);
       return;
     }
 
-    const auto item = reply.readJson().and_then(
-        [](const QJsonDocument& json) { return parseMedia(json["data"]["Media"]); });
+    const auto items = reply.readJson().and_then([](const QJsonDocument& json) {
+      const auto value = json["data"]["Page"]["media"];
+      if (!value.isArray()) return std::optional<QList<std::optional<Anime>>>{};
+      return std::make_optional(value.toArray() | std::views::transform(parseMedia) |
+                                std::ranges::to<QList>());
+    });
 
-    if (!item) {
-      handleError(reply, "Could not parse media object.");
+    if (!items) {
+      handleError(reply, "Could not parse media objects.");
       return;
     }
 
-    anime::db.updateItem(*item);
+    scheduler_->markParsed();
+
+    for (const auto& item : *items) {
+      if (item) anime::db.updateItem(*item);
+    }
   };
 
-  manager_.post(api_.createRequest(), data, this, callback);
+  scheduler_->post("MediaPage", api_.createRequest(), data, priority, callback);
 }
 
 void Service::search(const QString& query) {
+  fetchMediaPages(QJsonObject{{"query", query}});
+}
+
+void Service::fetchSeason(const anime::Season& season) {
+  const auto now = std::chrono::steady_clock::now();
+  if (const auto it = season_fetched_at_.find(season);
+      it != season_fetched_at_.end() && now - it->second < kSeasonFetchInterval) {
+    return;
+  }
+  season_fetched_at_[season] = now;
+
+  fetchMediaPages(QJsonObject{
+      {"season", fromSeasonName(season.name)},
+      {"seasonYear", static_cast<int>(season.year)},
+  });
+}
+
+// The first page tells how many there are, then the rest are requested at once.
+// Items are saved as each page arrives.
+void Service::fetchMediaPages(const QJsonObject& variables, const int page) {
+  auto pageVariables = variables;
+  pageVariables.insert("page", page);
+  pageVariables.insert("perPage", kMaxPerPage);
+
   const QJsonDocument data{{
       {"query", gql("MediaSearch")},
-      {"variables", QJsonObject{{"query", query}}},
+      {"variables", pageVariables},
   }};
 
-  const auto callback = [this](QRestReply& reply) {
+  const auto callback = [this, variables, page](QRestReply& reply) {
     if (isError(reply)) {
       handleError(reply);
       return;
     }
 
-    const auto items = reply.readJson().and_then([](const QJsonDocument& json) {
-      const auto value = json["data"]["Page"]["media"];
-      if (!value.isArray()) return std::optional<QList<std::optional<Anime>>>{};
-      return std::make_optional(value.toArray() | std::views::transform(parseMedia) |
-                                std::ranges::to<QList>());
-    });
+    const auto json = reply.readJson();
+    const auto value = json ? (*json)["data"]["Page"] : QJsonValue{};
 
-    if (!items) {
+    if (!value["media"].isArray()) {
       handleError(reply, "Could not parse search results.");
       return;
     }
 
-    for (const auto& item : *items) {
-      if (item) anime::db.updateItem(*item);
+    if (page == 1) {
+      const int lastPage = std::min(value["pageInfo"]["lastPage"].toInt(), kMaxPages);
+      for (int i = 2; i <= lastPage; ++i) {
+        fetchMediaPages(variables, i);
+      }
+    }
+
+    QList<Anime> items;
+    for (const auto object : value["media"].toArray()) {
+      if (auto item = parseMedia(object)) items.push_back(std::move(*item));
     }
+
+    scheduler_->markParsed();
+
+    anime::db.mergeList(items, {});
   };
 
-  manager_.post(api_.createRequest(), data, this, callback);
+  scheduler_->post("MediaSearch", api_.createRequest(), data, Priority::User, callback);
 }
 
 void Service::fetchListEntries() {
-  // @TODO
+  if (taiga::accounts.anilistUsername().empty()) return;
+
+  const auto since = anime::db.metaValue(kListUpdatedAt).toLongLong();
+  const auto syncedAt = anime::db.metaValue(kListSyncedAt).toLongLong();
+
+  // Changes are fetched by themselves, except for deleted entries, which only a
+  // complete list can reveal.
+  if (since && QDateTime::currentSecsSinceEpoch() - syncedAt < kFullSyncInterval.count()) {
+    fetchListPage(1, since, std::make_shared<MediaListCollection>());
+  } else {
+    fetchListCollection();
+  }
+}
+
+void Service::fetchListCollection() {
+  const QJsonDocument data{{
+      {"query", gql("MediaListCollection")},
+      {"variables",
+       QJsonObject{{"userName", QString::fromStdString(taiga::accounts.anilistUsername())}}},
+  }};
+
+  // Media are only decoded for entries that have changed. The list is compared
+  // against a snapshot, because the reader runs on another thread.
+  const auto reader = std::make_shared<MediaListCollectionReader>(
+      [entries = anime::db.entries(), items = anime::db.items()](const ListEntry& entry) {
+        const auto it = entries.constFind(entry.anime_id);
+        return it == entries.cend() || *it != entry || !items.contains(entry.anime_id);
+      });
+
+  const auto callback = [this, reader](QRestReply& reply) {
+    if (isError(reply)) {
+      handleError(reply);
+      return;
+    }
+
+    parsing_list_ = true;
+
+    // The list is parsed and applied after the callback returns
+    const auto trace = scheduler_->deferTrace();
+
+    parse_pool_.start([this, reader, trace, body = reply.readBody()]() {
+      reader->read(body);
+
+      QMetaObject::invokeMethod(
+          this,
+          [this, trace, collection = reader->result()]() {
+            parsing_list_ = false;
+
+            if (!collection) {
+              LOGE("Could not parse list entries.");
+              trace->finish();
+              return;
+            }
+
+            trace->markParsed();
+
+            anime::db.updateList(collection->items, collection->entries);
+
+            anime::db.setMetaValue(kListUpdatedAt,
+                                   QString::number(lastUpdated(collection->entries)));
+            anime::db.setMetaValue(kListSyncedAt,
+                                   QString::number(QDateTime::currentSecsSinceEpoch()));
+
+            trace->finish();
+          },
+          Qt::QueuedConnection);
+    });
+  };
+
+  // Large lists are decoded while they are being downloaded, so that the body
+  // is never buffered as a whole.
+  const auto sent = [this, reader](QNetworkReply* reply) {
+    connect(reply, &QNetworkReply::readyRead, this, [this, reply, reader]() {
+      if (reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() == 200) {
+        parse_pool_.start([reader, data = reply->readAll()]() { reader->read(data); });
+      }
+    });
+  };
+
+  scheduler_->post("MediaListCollection", api_.createRequest(), data, Priority::ListUpdate,
+                   callback, sent);
 }
 
-void Service::addListEntry() {
-  updateListEntry();
+// Entries are sorted by the time they were updated, so pages are fetched until
+// an entry that was already seen.
+void Service::fetchListPage(const int page, const std::time_t since,
+                            std::shared_ptr<MediaListCollection> changes) {
+  const QJsonDocument data{{
+      {"query", gql("MediaListPage")},
+      {"variables",
+       QJsonObject{
+           {"userName", QString::fromStdString(taiga::accounts.anilistUsername())},
+           {"page", page},
+           {"perPage", kMaxPerPage},
+       }},
+  }};
+
+  const auto callback = [this, page, since, changes](QRestReply& reply) {
+    if (isError(reply)) {
+      handleError(reply);
+      return;
+    }
+
+    const auto json = reply.readJson();
+    const auto value = json ? (*json)["data"]["Page"] : QJsonValue{};
+
+    if (!value["mediaList"].isArray()) {
+      handleError(reply, "Could not parse list entries.");
+      return;
+    }
+
+    bool hasMore = value["pageInfo"]["hasNextPage"].toBool();
+
+    for (const auto object : value["mediaList"].toArray()) {
+      auto entry = parseMediaList(object);
+      if (!entry) continue;
+      if (entry->last_updated < since) {
+        hasMore = false;
+        break;
+      }
+      // Entries updated within the same second as the newest one are seen twice
+      if (const auto current = anime::db.entry(entry->anime_id); current && *current == *entry) {
+        continue;
+      }
+      if (auto item = parseMedia(object["media"])) changes->items.push_back(std::move(*item));
+      changes->entries.push_back(std::move(*entry));
+    }
+
+    if (hasMore) {
+      fetchListPage(page + 1, since, changes);
+      return;
+    }
+
+    scheduler_->markParsed();
+
+    anime::db.mergeList(changes->items, changes->entries);
+
+    if (!changes->entries.isEmpty()) {
+      anime::db.setMetaValue(kListUpdatedAt, QString::number(lastUpdated(changes->entries)));
+    }
+  };
+
+  scheduler_->post("MediaListPage", api_.createRequest(), data, Priority::ListUpdate, callback);
 }
 
 void Service::deleteListEntry(const int id) {
@@ -168,22 +444,115 @@ void Service::deleteListEntry(const int id) {
     // @TODO: anime::db.deleteEntry(id);
   };
 
-  manager_.post(api_.createRequest(), data, this, callback);
+  scheduler_->post("DeleteMediaListEntry", api_.createRequest(), data, Priority::ListUpdate,
+                   callback);
+}
+
+void Service::updateListEntries(const QList<ListEntry>& entries) {
+  // Entries that are still being saved are sent with the next batch, if they
+  // have changed in the meantime
+  const auto pending = entries | std::views::filter([this](const ListEntry& entry) {
+                         return !saving_ids_.contains(entry.anime_id);
+                       }) |
+                       std::ranges::to<QList>();
+
+  for (const auto batch : pending | std::views::chunk(kMaxSavePerRequest)) {
+    saveListEntries(batch | std::ranges::to<QList>());
+  }
+}
+
+// Requests that were not made in the background are assumed to be awaited
+bool Service::isBusy() const {
+  return !pending_ids_.isEmpty() || parsing_list_ || scheduler_->isBusy(Priority::ListUpdate);
 }
 
-void Service::updateListEntry() {
-  // @TODO
+// Entries are saved in a single request, with an aliased mutation for each
+void Service::saveListEntries(const QList<ListEntry>& entries) {
+  QStringList variables;
+  QStringList mutations;
+  QJsonObject values;
+
+  for (qsizetype i = 0; i < entries.size(); ++i) {
+    const auto& entry = entries[i];
+    const bool isRewatching = entry.rewatching && entry.status == anime::list::Status::Watching;
+
+    variables.append(
+        u"$mediaId%1: Int, $status%1: MediaListStatus, $scoreRaw%1: Int, $progress%1: Int, "
+        "$repeat%1: Int, $private%1: Boolean, $notes%1: String, "
+        "$startedAt%1: FuzzyDateInput, $completedAt%1: FuzzyDateInput"_s.arg(i));
+    mutations.append(
+        u"entry%1: SaveMediaListEntry(mediaId: $mediaId%1, status: $status%1, "
+        "scoreRaw: $scoreRaw%1, progress: $progress%1, repeat: $repeat%1, private: $private%1, "
+        "notes: $notes%1, startedAt: $startedAt%1, completedAt: $completedAt%1) "
+        "{ ...mediaListFragment }"_s.arg(i));
+
+    values.insert(u"mediaId%1"_s.arg(i), entry.anime_id);
+    values.insert(u"status%1"_s.arg(i),
+                  isRewatching ? u"REPEATING"_s : fromListStatus(entry.status));
+    values.insert(u"scoreRaw%1"_s.arg(i), entry.score);
+    values.insert(u"progress%1"_s.arg(i), entry.watched_episodes);
+    values.insert(u"repeat%1"_s.arg(i), entry.rewatched_times);
+    values.insert(u"private%1"_s.arg(i), entry.is_private);
+    values.insert(u"notes%1"_s.arg(i), QString::fromStdString(entry.notes));
+    values.insert(u"startedAt%1"_s.arg(i), fromFuzzyDate(entry.date_started));
+    values.insert(u"completedAt%1"_s.arg(i), fromFuzzyDate(entry.date_completed));
+
+    saving_ids_.insert(entry.anime_id);
+  }
+
+  auto query = gql("SaveMediaListEntries");
+  query.replace("{variables}", variables.join(", "));
+  query.replace("{mutations}", mutations.join("\n  "));
+
+  const QJsonDocument data{{
+      {"query", query},
+      {"variables", values},
+  }};
+
+  // Entries that could not be saved remain in the queue
+  const auto callback = [this, entries](QRestReply& reply) {
+    for (const auto& entry : entries) {
+      saving_ids_.remove(entry.anime_id);
+    }
+
+    if (isError(reply)) {
+      handleError(reply);
+      return;
+    }
+
+    const auto json = reply.readJson();
+
+    if (!json) {
+      handleError(reply, "Could not parse list entries.");
+      return;
+    }
+
+    for (qsizetype i = 0; i < entries.size(); ++i) {
+      if (const auto saved = parseMediaList((*json)["data"][u"entry%1"_s.arg(i)])) {
+        anime::db.dequeueEntry(entries[i], *saved);
+      }
+    }
+  };
+
+  scheduler_->post("SaveMediaListEntries", api_.createRequest(), data, Priority::ListUpdate,
+                   callback);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 QString Service::gql(const QString& name) const {
-  return base::readFile(u":/gql/anilist/%1.gql"_s.arg(name));
+  auto query = base::readFile(u":/gql/anilist/%1.gql"_s.arg(name));
+
+  // Fields are shared between queries
+  query.replace("{mediaFields}", base::readFile(":/gql/anilist/MediaFields.gql"));
+  query.replace("{mediaListFields}", base::readFile(":/gql/anilist/MediaListFields.gql"));
+
+  return query;
 }
 
 bool Service::isError(const QRestReply& reply) const {
+  // Rate limiting is handled by the scheduler
   return !reply.isHttpStatusSuccess() || reply.hasError();
-  // @TODO: Check DDoS protection
 }
 
 void Service::handleError(const QRestReply& reply, const QString& message) const {
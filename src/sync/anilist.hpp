@@ -18,29 +18,64 @@
 
 #pragma once
 
+#include <QList>
+#include <QSet>
+#include <QThreadPool>
+#include <chrono>
+#include <ctime>
+#include <map>
+#include <memory>
+
+#include "media/anime_list.hpp"
+#include "media/anime_season.hpp"
 #include "sync/service.hpp"
 
+class QJsonObject;
+class QTimer;
+
 namespace sync::anilist {
 
+struct MediaListCollection;
+
 class Service final : public sync::Service {
 public:
   Service();
 
   static Service* instance();
 
+  void preconnect();
   void authenticateUser();
   void fetchAnime(const int id);
+  void refreshAnime(const QList<int>& ids);
   void search(const QString& query);
+  void fetchSeason(const anime::Season& season);
   void fetchListEntries();
-  void addListEntry();
   void deleteListEntry(const int id);
-  void updateListEntry();
+  void updateListEntries(const QList<ListEntry>& entries);
+
+  bool isBusy() const;
 
 private:
+  void fetchPendingAnime();
+  void fetchAnimePage(const QList<int>& ids, const Priority priority = Priority::User);
+  void fetchMediaPages(const QJsonObject& variables, const int page = 1);
+  void fetchListCollection();
+  void fetchListPage(const int page, const std::time_t since,
+                     std::shared_ptr<MediaListCollection> changes);
+  void saveListEntries(const QList<ListEntry>& entries);
+
   QString gql(const QString& name) const;
 
   bool isError(const QRestReply& reply) const;
   void handleError(const QRestReply& reply, const QString& message = {}) const;
+
+  QSet<int> pending_ids_;
+  QSet<int> fetching_ids_;
+  QSet<int> saving_ids_;
+  QTimer* fetch_timer_ = nullptr;
+  std::map<anime::Season, std::chrono::steady_clock::time_point> season_fetched_at_;
+  QThreadPool parse_pool_;
+  bool parsing_list_ = false;
 };
 
 }  // namespace sync::anilist
@@ -23,6 +23,7 @@
 #include <QJsonObject>
 #include <QJsonValue>
 #include <QMap>
+#include <QSet>
 #include <QString>
 #include <QUrl>
 #include <QUrlQuery>
@@ -51,6 +52,7 @@ anime::list::Status parseListStatus(const QString& value) {
       {"COMPLETED", Status::Completed},
       {"DROPPED",   Status::Dropped},
       {"PAUSED",    Status::OnHold},
+      {"REPEATING", Status::Watching},
   };
   // clang-format on
   return table.value(value, Status::NotInList);
@@ -115,6 +117,10 @@ std::optional<Anime> parseMedia(const QJsonValue& json) {
       },
   };
 
+  // Other services are mapped to ours, so that we can switch between them
+  item.uids["anilist"] = id;
+  if (const int idMal = json["idMal"].toInt()) item.uids["myanimelist"] = idMal;
+
   const auto nativeTitle = json["title"]["native"].toString().toStdString();
   if (!nativeTitle.empty()) {
     if (json["countryOfOrigin"] == "JP") {
@@ -159,4 +165,60 @@ std::optional<Anime> parseMedia(const QJsonValue& json) {
   return item;
 }
 
+std::optional<ListEntry> parseMediaList(const QJsonValue& json) {
+  const auto id = json["id"].toInteger();
+  const int animeId = json["media"]["id"].toInt();
+
+  if (!id || !animeId) return std::nullopt;
+
+  return ListEntry{
+      .id = id,
+      .anime_id = animeId,
+      .watched_episodes = json["progress"].toInt(),
+      .score = json["score"].toInt(),
+      .status = parseListStatus(json["status"].toString()),
+      .is_private = json["private"].toBool(),
+      .rewatched_times = json["repeat"].toInt(),
+      .rewatching = json["status"] == "REPEATING",
+      .date_started = parseFuzzyDate(json["startedAt"]),
+      .date_completed = parseFuzzyDate(json["completedAt"]),
+      .last_updated = json["updatedAt"].toInteger(),
+      .notes = json["notes"].toString().toStdString(),
+  };
+}
+
+MediaListCollectionReader::MediaListCollectionReader(filter_t filter) : filter_{std::move(filter)} {
+  reader_.addPath({"data", "MediaListCollection", "lists", "[]", "entries", "[]"},
+                  [this](std::string_view value) { readEntry(value); });
+  reader_.addPath({"errors"}, [this](std::string_view value) { has_errors_ = value != "null"; });
+}
+
+bool MediaListCollectionReader::read(const QByteArray& data) {
+  return reader_.feed({data.constData(), static_cast<size_t>(data.size())});
+}
+
+std::optional<MediaListCollection> MediaListCollectionReader::result() const {
+  if (has_errors_ || reader_.hasError() || !reader_.isFinished()) return std::nullopt;
+  return collection_;
+}
+
+void MediaListCollectionReader::readEntry(std::string_view value) {
+  const auto json = QJsonDocument::fromJson(
+      QByteArray::fromRawData(value.data(), static_cast<qsizetype>(value.size())));
+
+  if (!json.isObject()) return;
+
+  const QJsonValue object{json.object()};
+
+  // Entries also appear in custom lists
+  auto entry = parseMediaList(object);
+  if (!entry || ids_.contains(entry->anime_id)) return;
+  ids_.insert(entry->anime_id);
+
+  if (!filter_ || filter_(*entry)) {
+    if (auto item = parseMedia(object["media"])) collection_.items.push_back(std::move(*item));
+  }
+  collection_.entries.push_back(std::move(*entry));
+}
+
 }  // namespace sync::anilist
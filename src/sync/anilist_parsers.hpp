@@ -18,26 +18,24 @@
 
 #pragma once
 
+#include <QByteArray>
+#include <QList>
+#include <QSet>
 #include <QString>
+#include <functional>
 #include <optional>
 #include <string>
 
+#include "base/json.hpp"
+#include "media/anime.hpp"
+#include "media/anime_list.hpp"
+
 class QJsonValue;
 
 namespace base {
 class FuzzyDate;
 }
 
-namespace anime {
-enum class Status;
-enum class Type;
-struct Details;
-}  // namespace anime
-
-namespace anime::list {
-enum class Status;
-}
-
 namespace sync::anilist {
 
 base::FuzzyDate parseFuzzyDate(const QJsonValue& json);
@@ -47,5 +45,35 @@ anime::Status parseStatus(const QString& value);
 anime::Type parseType(const QString& value);
 
 std::optional<anime::Details> parseMedia(const QJsonValue& json);
+std::optional<ListEntry> parseMediaList(const QJsonValue& json);
+
+struct MediaListCollection {
+  QList<Anime> items;
+  QList<ListEntry> entries;
+};
+
+// Decodes list entries one at a time as the response arrives, instead of
+// building a document for the whole list. Media are only decoded for entries
+// that pass the filter.
+class MediaListCollectionReader {
+public:
+  using filter_t = std::function<bool(const ListEntry&)>;
+
+  MediaListCollectionReader(filter_t filter = {});
+  MediaListCollectionReader(const MediaListCollectionReader&) = delete;
+  MediaListCollectionReader& operator=(const MediaListCollectionReader&) = delete;
+
+  bool read(const QByteArray& data);
+  std::optional<MediaListCollection> result() const;
+
+private:
+  void readEntry(std::string_view value);
+
+  base::JsonStreamReader reader_;
+  filter_t filter_;
+  MediaListCollection collection_;
+  QSet<int> ids_;
+  bool has_errors_ = false;
+};
 
 }  // namespace sync::anilist
@@ -0,0 +1,79 @@
+/**
+ * Taiga
+ * Copyright (C) 2010-2025, Eren Okka
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "queue.hpp"
+
+#include <QNetworkInformation>
+#include <QTimer>
+
+#include "media/anime_db.hpp"
+#include "sync/anilist.hpp"
+#include "sync/service.hpp"
+#include "taiga/settings.hpp"
+
+namespace sync {
+
+namespace {
+
+bool isOnline() {
+  // Assume that we are, if there is no way to tell
+  const auto info = QNetworkInformation::instance();
+  return !info || info->reachability() != QNetworkInformation::Reachability::Disconnected;
+}
+
+}  // namespace
+
+void Queue::init() {
+  timer_ = new QTimer(this);
+  timer_->setSingleShot(true);
+  connect(timer_, &QTimer::timeout, this, &Queue::flush);
+
+  connect(&anime::db, &anime::Database::entryQueued, this,
+          [this]() { timer_->start(taiga::settings.syncQueueDelay()); });
+
+  // Changes that were made while offline are sent as soon as we are back
+  if (QNetworkInformation::loadDefaultBackend()) {
+    connect(QNetworkInformation::instance(), &QNetworkInformation::reachabilityChanged, this,
+            [this]() {
+              if (isOnline() && !anime::db.queuedEntries().isEmpty()) timer_->start(0);
+            });
+  }
+
+  // Changes that could not be sent before are sent on startup
+  if (!anime::db.queuedEntries().isEmpty()) timer_->start(0);
+}
+
+void Queue::flush() {
+  if (timer_) timer_->stop();
+
+  const auto entries = anime::db.queuedEntries().values();
+
+  if (entries.isEmpty() || !isOnline()) return;
+
+  switch (currentServiceId()) {
+    case ServiceId::MyAnimeList:
+      break;
+    case ServiceId::Kitsu:
+      break;
+    case ServiceId::AniList:
+      anilist::Service::instance()->updateListEntries(entries);
+      break;
+  }
+}
+
+}  // namespace sync
@@ -0,0 +1,41 @@
+/**
+ * Taiga
+ * Copyright (C) 2010-2025, Eren Okka
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QObject>
+
+class QTimer;
+
+namespace sync {
+
+// Sends the list changes that are queued in the database to the current
+// service. Changes are held for a while, so that consecutive edits to the same
+// entry (e.g. watching a series episode by episode) are sent as one.
+class Queue final : public QObject {
+public:
+  void init();
+  void flush();
+
+private:
+  QTimer* timer_ = nullptr;
+};
+
+inline Queue queue;
+
+}  // namespace sync
@@ -0,0 +1,159 @@
+/**
+ * Taiga
+ * Copyright (C) 2010-2025, Eren Okka
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "refresher.hpp"
+
+#include <QCoreApplication>
+#include <QEvent>
+#include <QTimer>
+#include <algorithm>
+#include <ranges>
+#include <tuple>
+#include <utility>
+
+#include "media/anime_db.hpp"
+#include "media/anime_utils.hpp"
+#include "sync/service.hpp"
+#include "taiga/settings.hpp"
+
+namespace sync {
+
+namespace {
+
+constexpr auto kInterval = std::chrono::minutes{1};
+constexpr auto kIdleDelay = std::chrono::minutes{2};
+constexpr auto kBudgetPeriod = std::chrono::hours{1};
+
+// Some items remain stale after being refreshed (e.g. a series that is yet to
+// have a synopsis), so they are left alone for a while
+constexpr auto kRetryDelay = std::chrono::hours{6};
+
+// Matches the number of items that a service returns per page
+constexpr qsizetype kItemsPerRequest = 50;
+
+int relevance(const anime::list::Status status) {
+  switch (status) {
+    case anime::list::Status::Watching:
+      return 0;
+    case anime::list::Status::PlanToWatch:
+      return 1;
+    case anime::list::Status::NotInList:
+      return 3;
+    default:
+      return 2;
+  }
+}
+
+}  // namespace
+
+void Refresher::init() {
+  last_input_ = clock_t::now();
+
+  timer_ = new QTimer(this);
+  timer_->setInterval(kInterval);
+  connect(timer_, &QTimer::timeout, this, &Refresher::refresh);
+  timer_->start();
+
+  qApp->installEventFilter(this);
+}
+
+bool Refresher::eventFilter(QObject* watched, QEvent* event) {
+  switch (event->type()) {
+    case QEvent::KeyPress:
+    case QEvent::MouseButtonPress:
+    case QEvent::Wheel:
+      last_input_ = clock_t::now();
+      break;
+    default:
+      break;
+  }
+  return QObject::eventFilter(watched, event);
+}
+
+bool Refresher::isIdle() const {
+  return clock_t::now() - last_input_ >= kIdleDelay && !sync::isBusy();
+}
+
+bool Refresher::isWithinBudget() {
+  const auto now = clock_t::now();
+
+  while (!requests_.empty() && now - requests_.front() >= kBudgetPeriod) {
+    requests_.pop_front();
+  }
+
+  return std::cmp_less(requests_.size(), taiga::settings.syncRefreshBudget());
+}
+
+QList<int> Refresher::staleItems(const qsizetype count) const {
+  const auto now = clock_t::now();
+
+  struct Candidate {
+    int relevance = 0;
+    std::time_t last_modified = 0;
+    int id = 0;
+  };
+
+  QList<Candidate> candidates;
+
+  for (const auto& item : anime::db.items()) {
+    if (const auto it = refreshed_at_.find(item.id);
+        it != refreshed_at_.end() && now - *it < kRetryDelay) {
+      continue;
+    }
+    if (!anime::isStale(item)) continue;
+
+    const auto entry = anime::db.entry(item.id);
+    const auto status = entry ? entry->status : anime::list::Status::NotInList;
+
+    candidates.append({relevance(status), item.last_modified, item.id});
+  }
+
+  std::ranges::sort(candidates, {}, [](const Candidate& candidate) {
+    return std::tie(candidate.relevance, candidate.last_modified);
+  });
+
+  QList<int> ids;
+
+  for (const auto& candidate : candidates | std::views::take(count)) {
+    ids.append(candidate.id);
+  }
+
+  return ids;
+}
+
+void Refresher::refresh() {
+  // Anything that the user does takes precedence, so we wait until they are
+  // done before making another request
+  if (!isIdle() || !isWithinBudget()) return;
+
+  const auto ids = staleItems(kItemsPerRequest);
+
+  if (ids.isEmpty()) return;
+
+  const auto now = clock_t::now();
+
+  for (const auto id : ids) {
+    refreshed_at_.insert(id, now);
+  }
+
+  requests_.push_back(now);
+
+  sync::refreshAnime(ids);
+}
+
+}  // namespace sync
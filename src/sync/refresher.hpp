@@ -0,0 +1,57 @@
+/**
+ * Taiga
+ * Copyright (C) 2010-2025, Eren Okka
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <chrono>
+#include <deque>
+
+class QTimer;
+
+namespace sync {
+
+// Refreshes stale metadata in the background, while the user is away. Items on
+// the list are refreshed first, and the number of requests is limited per hour
+// so as not to compete with the requests that the user is waiting for.
+class Refresher final : public QObject {
+public:
+  using clock_t = std::chrono::steady_clock;
+
+  void init();
+
+protected:
+  bool eventFilter(QObject* watched, QEvent* event) override;
+
+private:
+  bool isIdle() const;
+  bool isWithinBudget();
+  QList<int> staleItems(const qsizetype count) const;
+  void refresh();
+
+  QTimer* timer_ = nullptr;
+  clock_t::time_point last_input_;
+  std::deque<clock_t::time_point> requests_;
+  QHash<int, clock_t::time_point> refreshed_at_;
+};
+
+inline Refresher refresher;
+
+}  // namespace sync
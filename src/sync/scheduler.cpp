@@ -0,0 +1,263 @@
+/**
+ * Taiga
+ * Copyright (C) 2010-2025, Eren Okka
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "scheduler.hpp"
+
+#include <QNetworkReply>
+#include <QRestAccessManager>
+#include <QRestReply>
+#include <QTimer>
+#include <algorithm>
+#include <memory>
+#include <optional>
+#include <ranges>
+#include <utility>
+
+#include "base/log.hpp"
+
+namespace sync {
+
+namespace {
+
+// Services also limit short bursts, so the bucket is kept small
+constexpr double kMaxBurst = 10.0;
+
+constexpr int kMaxAttempts = 5;
+constexpr auto kMinBackoff = std::chrono::seconds{1};
+constexpr auto kMaxBackoff = std::chrono::seconds{60};
+
+constexpr int kTooManyRequests = 429;
+
+std::optional<int> headerValue(const QRestReply& reply, const char* name) {
+  bool ok = false;
+  const int value = reply.networkReply()->rawHeader(name).toInt(&ok);
+  return ok ? std::make_optional(value) : std::nullopt;
+}
+
+}  // namespace
+
+RequestScheduler::RequestScheduler(QRestAccessManager& manager, const QString& service,
+                                   int requestsPerMinute, QObject* parent)
+    : QObject{parent},
+      manager_{manager},
+      service_{service},
+      timer_{new QTimer(this)},
+      refilled_at_{clock_t::now()} {
+  setRateLimit(requestsPerMinute);
+  tokens_ = kMaxBurst;
+
+  timer_->setSingleShot(true);
+  connect(timer_, &QTimer::timeout, this, &RequestScheduler::dispatch);
+}
+
+void RequestScheduler::setRateLimit(int requestsPerMinute) {
+  refill();
+  limit_ = std::max(1, requestsPerMinute);
+}
+
+void RequestScheduler::post(const QString& operation, const QNetworkRequest& request,
+                            const QJsonDocument& data, Priority priority, reply_callback_t callback,
+                            sent_callback_t sent) {
+  queues_[static_cast<size_t>(priority)].push_back({
+      .operation = operation,
+      .request = request,
+      .data = data,
+      .priority = priority,
+      .callback = std::move(callback),
+      .sent = std::move(sent),
+      .queued_at = clock_t::now(),
+  });
+
+  dispatch();
+}
+
+void RequestScheduler::dispatch() {
+  using namespace std::chrono;
+
+  refill();
+
+  const auto now = clock_t::now();
+
+  if (now < paused_until_) {
+    timer_->start(ceil<milliseconds>(paused_until_ - now));
+    return;
+  }
+
+  for (auto& queue : queues_ | std::views::reverse) {
+    while (!queue.empty() && tokens_ >= 1.0) {
+      tokens_ -= 1.0;
+      auto request = std::move(queue.front());
+      queue.pop_front();
+      send(std::move(request));
+    }
+  }
+
+  if (std::ranges::all_of(queues_, [](const auto& queue) { return queue.empty(); })) return;
+
+  // Wait until the next token is available
+  const duration<double> wait{(1.0 - tokens_) * 60.0 / limit_};
+  timer_->start(ceil<milliseconds>(wait));
+}
+
+void RequestScheduler::refill() {
+  const auto now = clock_t::now();
+  const std::chrono::duration<double> elapsed = now - refilled_at_;
+  refilled_at_ = now;
+  if (limit_ > 0) tokens_ = std::min(kMaxBurst, tokens_ + elapsed.count() * limit_ / 60.0);
+}
+
+void RequestScheduler::markParsed() {
+  parsed_at_ = clock_t::now();
+}
+
+std::shared_ptr<RequestScheduler::DeferredTrace> RequestScheduler::deferTrace() {
+  if (!deferred_) deferred_ = std::make_shared<DeferredTrace>();
+  return deferred_;
+}
+
+void RequestScheduler::DeferredTrace::markParsed() {
+  parsed_at_ = clock_t::now();
+}
+
+void RequestScheduler::DeferredTrace::finish() {
+  using std::chrono::duration_cast;
+  using std::chrono::microseconds;
+
+  if (std::exchange(recorded_, true)) return;
+
+  const auto done = clock_t::now();
+  const auto parsed = parsed_at_.value_or(done);
+
+  trace_[Span::Parse] = duration_cast<microseconds>(parsed - finished_);
+  trace_[Span::Apply] = duration_cast<microseconds>(done - parsed);
+
+  tracer.add(trace_);
+}
+
+bool RequestScheduler::isBusy(Priority priority) const {
+  for (auto i = static_cast<size_t>(priority); i < queues_.size(); ++i) {
+    if (!queues_[i].empty() || in_flight_[i] > 0) return true;
+  }
+  return false;
+}
+
+void RequestScheduler::send(Request request) {
+  using std::chrono::duration_cast;
+  using std::chrono::microseconds;
+
+  struct Timeline {
+    clock_t::time_point sent = clock_t::now();
+    std::optional<clock_t::time_point> connecting;
+    std::optional<clock_t::time_point> request_sent;
+    std::optional<clock_t::time_point> headers;
+  };
+
+  const auto timeline = std::make_shared<Timeline>();
+
+  const auto index = static_cast<size_t>(request.priority);
+  ++in_flight_[index];
+
+  const auto callback = [this, request, timeline, index](QRestReply& reply) {
+    --in_flight_[index];
+    readLimits(reply);
+
+    if (reply.httpStatus() == kTooManyRequests && request.attempts + 1 < kMaxAttempts) {
+      retry(request, reply);
+      return;
+    }
+
+    const auto finished = clock_t::now();
+    const auto sent = timeline->request_sent.value_or(timeline->sent);
+    const auto headers = timeline->headers.value_or(finished);
+
+    Trace trace{.service = service_, .operation = request.operation, .start = request.queued_at};
+    trace[Span::Queue] = duration_cast<microseconds>(timeline->sent - request.queued_at);
+    if (timeline->connecting) {
+      trace[Span::Connect] = duration_cast<microseconds>(sent - *timeline->connecting);
+    }
+    trace[Span::Server] = duration_cast<microseconds>(headers - sent);
+    trace[Span::Transfer] = duration_cast<microseconds>(finished - headers);
+
+    parsed_at_.reset();
+    deferred_.reset();
+    if (request.callback) request.callback(reply);
+
+    // Deferred traces are finished later from the event loop, so they can
+    // still be completed here.
+    if (const auto deferred = std::exchange(deferred_, nullptr)) {
+      deferred->trace_ = std::move(trace);
+      deferred->finished_ = finished;
+      deferred->parsed_at_ = parsed_at_;
+      return;
+    }
+
+    const auto done = clock_t::now();
+    const auto parsed = parsed_at_.value_or(done);
+
+    trace[Span::Parse] = duration_cast<microseconds>(parsed - finished);
+    trace[Span::Apply] = duration_cast<microseconds>(done - parsed);
+
+    tracer.add(trace);
+  };
+
+  const auto reply = manager_.post(request.request, request.data, this, callback);
+
+  connect(reply, &QNetworkReply::socketStartedConnecting, this,
+          [timeline]() { timeline->connecting = clock_t::now(); });
+  connect(reply, &QNetworkReply::requestSent, this,
+          [timeline]() { timeline->request_sent = clock_t::now(); });
+  connect(reply, &QNetworkReply::metaDataChanged, this, [timeline]() {
+    if (!timeline->headers) timeline->headers = clock_t::now();
+  });
+
+  if (request.sent) request.sent(reply);
+}
+
+void RequestScheduler::retry(Request request, const QRestReply& reply) {
+  using namespace std::chrono;
+
+  ++request.attempts;
+
+  const auto delay = std::clamp(headerValue(reply, "Retry-After")
+                                    .transform([](int value) { return seconds{value}; })
+                                    .value_or(kMinBackoff * (1 << request.attempts)),
+                                kMinBackoff, kMaxBackoff);
+
+  LOGW("Rate limited, retrying in {} seconds.", delay.count());
+
+  refill();
+  tokens_ = 0.0;
+  paused_until_ = std::max(paused_until_, clock_t::now() + delay);
+
+  queues_[static_cast<size_t>(request.priority)].push_front(std::move(request));
+
+  dispatch();
+}
+
+void RequestScheduler::readLimits(const QRestReply& reply) {
+  if (const auto limit = headerValue(reply, "X-RateLimit-Limit"); limit && *limit != limit_) {
+    setRateLimit(*limit);
+  }
+
+  if (const auto remaining = headerValue(reply, "X-RateLimit-Remaining")) {
+    refill();
+    tokens_ = std::min(tokens_, static_cast<double>(*remaining));
+  }
+}
+
+}  // namespace sync
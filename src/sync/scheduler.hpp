@@ -0,0 +1,128 @@
+/**
+ * Taiga
+ * Copyright (C) 2010-2025, Eren Okka
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QJsonDocument>
+#include <QNetworkRequest>
+#include <QObject>
+#include <QString>
+#include <array>
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <optional>
+
+#include "sync/trace.hpp"
+
+class QNetworkReply;
+class QRestAccessManager;
+class QRestReply;
+class QTimer;
+
+namespace sync {
+
+// Requests of higher priority are sent first
+enum class Priority {
+  Background,
+  ListUpdate,
+  User,
+};
+
+// Sends requests within the rate limit of a service, in order of priority. The
+// limit is adjusted from response headers, and requests that are rejected for
+// exceeding it are retried after a delay.
+//
+// Each request is traced, from the time it is queued until its callback
+// returns. Callbacks can call `markParsed` to tell parsing from applying, or
+// `deferTrace` if the response is processed after they return.
+class RequestScheduler final : public QObject {
+public:
+  using clock_t = std::chrono::steady_clock;
+  using reply_callback_t = std::function<void(QRestReply&)>;
+  using sent_callback_t = std::function<void(QNetworkReply*)>;
+
+  // Trace of a request that is recorded when `finish` is called, rather than
+  // when its callback returns
+  class DeferredTrace final {
+  public:
+    void markParsed();
+    void finish();
+
+  private:
+    friend class RequestScheduler;
+
+    Trace trace_;
+    clock_t::time_point finished_;
+    std::optional<clock_t::time_point> parsed_at_;
+    bool recorded_ = false;
+  };
+
+  RequestScheduler(QRestAccessManager& manager, const QString& service, int requestsPerMinute,
+                   QObject* parent);
+
+  void setRateLimit(int requestsPerMinute);
+
+  void post(const QString& operation, const QNetworkRequest& request, const QJsonDocument& data,
+            Priority priority, reply_callback_t callback, sent_callback_t sent = {});
+
+  void markParsed();
+
+  // Can only be called from within a callback
+  std::shared_ptr<DeferredTrace> deferTrace();
+
+  // Whether there are requests of the given priority or higher that are yet to
+  // be answered
+  bool isBusy(Priority priority) const;
+
+private:
+  struct Request {
+    QString operation;
+    QNetworkRequest request;
+    QJsonDocument data;
+    Priority priority = Priority::User;
+    reply_callback_t callback;
+    sent_callback_t sent;
+    int attempts = 0;
+    clock_t::time_point queued_at;
+  };
+
+  void dispatch();
+  void refill();
+  void send(Request request);
+  void retry(Request request, const QRestReply& reply);
+  void readLimits(const QRestReply& reply);
+
+  QRestAccessManager& manager_;
+  QString service_;
+  QTimer* timer_ = nullptr;
+
+  std::array<std::deque<Request>, 3> queues_;
+  std::array<int, 3> in_flight_{};
+
+  int limit_ = 0;
+  double tokens_ = 0.0;
+  clock_t::time_point refilled_at_;
+  clock_t::time_point paused_until_;
+
+  std::optional<clock_t::time_point> parsed_at_;
+  std::shared_ptr<DeferredTrace> deferred_;
+};
+
+}  // namespace sync
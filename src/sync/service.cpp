@@ -24,12 +24,22 @@
 #include "sync/anilist_utils.hpp"
 #include "sync/kitsu_utils.hpp"
 #include "sync/myanimelist_utils.hpp"
+#include "sync/queue.hpp"
 #include "taiga/network.hpp"
 #include "taiga/settings.hpp"
 
 namespace sync {
 
-Service::Service() : QObject{qApp}, manager_{taiga::network()} {
+namespace {
+
+constexpr int kDefaultRateLimit = 60;
+
+}  // namespace
+
+Service::Service(const ServiceId id)
+    : QObject{qApp},
+      manager_{taiga::network()},
+      scheduler_{new RequestScheduler{manager_, serviceName(id), kDefaultRateLimit, this}} {
   api_.setCommonHeaders(taiga::NetworkAccessManager::commonHeaders());
 }
 
@@ -69,6 +79,18 @@ QString serviceSlug(const ServiceId serviceId) {
   return "taiga";
 }
 
+void preconnect() {
+  switch (currentServiceId()) {
+    case ServiceId::MyAnimeList:
+      break;
+    case ServiceId::Kitsu:
+      break;
+    case ServiceId::AniList:
+      anilist::Service::instance()->preconnect();
+      break;
+  }
+}
+
 void fetchAnime(const int id) {
   switch (currentServiceId()) {
     case ServiceId::MyAnimeList:
@@ -81,6 +103,57 @@ void fetchAnime(const int id) {
   }
 }
 
+void refreshAnime(const QList<int>& ids) {
+  switch (currentServiceId()) {
+    case ServiceId::MyAnimeList:
+      break;
+    case ServiceId::Kitsu:
+      break;
+    case ServiceId::AniList:
+      anilist::Service::instance()->refreshAnime(ids);
+      break;
+  }
+}
+
+void fetchSeason(const anime::Season& season) {
+  switch (currentServiceId()) {
+    case ServiceId::MyAnimeList:
+      break;
+    case ServiceId::Kitsu:
+      break;
+    case ServiceId::AniList:
+      anilist::Service::instance()->fetchSeason(season);
+      break;
+  }
+}
+
+void synchronize() {
+  // Our changes are sent first, so that they are not overwritten
+  queue.flush();
+
+  switch (currentServiceId()) {
+    case ServiceId::MyAnimeList:
+      break;
+    case ServiceId::Kitsu:
+      break;
+    case ServiceId::AniList:
+      anilist::Service::instance()->fetchListEntries();
+      break;
+  }
+}
+
+bool isBusy() {
+  switch (currentServiceId()) {
+    case ServiceId::MyAnimeList:
+      break;
+    case ServiceId::Kitsu:
+      break;
+    case ServiceId::AniList:
+      return anilist::Service::instance()->isBusy();
+  }
+  return false;
+}
+
 QString animePageUrl(const int id) {
   switch (currentServiceId()) {
     case ServiceId::MyAnimeList:
@@ -18,10 +18,17 @@
 
 #pragma once
 
+#include <QList>
 #include <QNetworkRequestFactory>
 #include <QRestAccessManager>
 #include <QString>
 
+#include "sync/scheduler.hpp"
+
+namespace anime {
+class Season;
+}
+
 namespace sync {
 
 enum class ServiceId {
@@ -38,12 +45,13 @@ struct Rating {
 
 class Service : public QObject {
 public:
-  Service();
+  Service(const ServiceId id);
   ~Service() = default;
 
 protected:
   QNetworkRequestFactory api_;
   QRestAccessManager manager_;
+  RequestScheduler* scheduler_ = nullptr;
 };
 
 ServiceId currentServiceId();
@@ -51,7 +59,12 @@ ServiceId serviceIdFromSlug(const QString& slug);
 QString serviceName(const ServiceId serviceId);
 QString serviceSlug(const ServiceId serviceId);
 
+void preconnect();
 void fetchAnime(const int id);
+void refreshAnime(const QList<int>& ids);
+void fetchSeason(const anime::Season& season);
+void synchronize();
+bool isBusy();
 
 QString animePageUrl(const int id);
 
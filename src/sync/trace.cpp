@@ -0,0 +1,126 @@
+/**
+ * Taiga
+ * Copyright (C) 2010-2025, Eren Okka
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "trace.hpp"
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <algorithm>
+#include <vector>
+
+namespace sync {
+
+namespace {
+
+constexpr size_t kMaxSamples = 200;
+constexpr size_t kMaxTraces = 1000;
+
+std::chrono::microseconds percentile(std::vector<std::chrono::microseconds>& values,
+                                     const double p) {
+  if (values.empty()) return {};
+  const auto n = static_cast<size_t>(p * static_cast<double>(values.size() - 1));
+  std::ranges::nth_element(values, values.begin() + n);
+  return values[n];
+}
+
+}  // namespace
+
+std::chrono::microseconds& Trace::operator[](const Span span) {
+  return spans[static_cast<size_t>(span)];
+}
+
+void Tracer::add(const Trace& trace) {
+  auto& samples = samples_[{trace.service, trace.operation}];
+
+  for (size_t i = 0; i < kSpans.size(); ++i) {
+    samples[i].push_back(trace.spans[i]);
+    if (samples[i].size() > kMaxSamples) samples[i].pop_front();
+  }
+
+  traces_.push_back(trace);
+  if (traces_.size() > kMaxTraces) traces_.pop_front();
+}
+
+QList<SpanSummary> Tracer::summary() const {
+  QList<SpanSummary> summary;
+
+  for (const auto& [key, samples] : samples_.asKeyValueRange()) {
+    for (size_t i = 0; i < kSpans.size(); ++i) {
+      std::vector values(samples[i].begin(), samples[i].end());
+      summary.append({
+          .service = key.first,
+          .operation = key.second,
+          .span = kSpans[i],
+          .count = static_cast<qsizetype>(values.size()),
+          .p50 = percentile(values, 0.50),
+          .p90 = percentile(values, 0.90),
+          .p99 = percentile(values, 0.99),
+      });
+    }
+  }
+
+  return summary;
+}
+
+// Uses the Trace Event Format, which can be viewed in chrome://tracing or
+// Perfetto. Each request is shown on its own row, with its spans in order.
+QByteArray Tracer::toJson() const {
+  using namespace std::chrono;
+
+  QJsonArray events;
+
+  for (int id = 0; const auto& trace : traces_) {
+    auto ts = duration_cast<microseconds>(trace.start.time_since_epoch());
+    for (size_t i = 0; i < kSpans.size(); ++i) {
+      const auto dur = trace.spans[i];
+      if (dur.count() > 0) {
+        events.append(QJsonObject{
+            {"name", spanName(kSpans[i])},
+            {"cat", trace.service},
+            {"ph", "X"},
+            {"ts", static_cast<qint64>(ts.count())},
+            {"dur", static_cast<qint64>(dur.count())},
+            {"pid", 1},
+            {"tid", id},
+            {"args", QJsonObject{{"operation", trace.operation}}},
+        });
+      }
+      ts += dur;
+    }
+    ++id;
+  }
+
+  return QJsonDocument{QJsonObject{{"traceEvents", events}}}.toJson(QJsonDocument::Compact);
+}
+
+QString spanName(const Span span) {
+  // clang-format off
+  switch (span) {
+    case Span::Queue: return "Queue";
+    case Span::Connect: return "Connect";
+    case Span::Server: return "Server";
+    case Span::Transfer: return "Transfer";
+    case Span::Parse: return "Parse";
+    case Span::Apply: return "Apply";
+  }
+  // clang-format on
+  return {};
+}
+
+}  // namespace sync
@@ -0,0 +1,90 @@
+/**
+ * Taiga
+ * Copyright (C) 2010-2025, Eren Okka
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QByteArray>
+#include <QList>
+#include <QMap>
+#include <QString>
+#include <array>
+#include <chrono>
+#include <deque>
+#include <utility>
+
+namespace sync {
+
+// Phases of a request, in the order they happen. Qt does not report the name
+// lookup and the TLS handshake by themselves, so they are included in `Connect`.
+enum class Span {
+  Queue,
+  Connect,
+  Server,
+  Transfer,
+  Parse,
+  Apply,
+};
+
+constexpr std::array kSpans{
+    Span::Queue, Span::Connect, Span::Server, Span::Transfer, Span::Parse, Span::Apply,
+};
+
+struct Trace {
+  using clock_t = std::chrono::steady_clock;
+  using spans_t = std::array<std::chrono::microseconds, kSpans.size()>;
+
+  QString service;
+  QString operation;
+  clock_t::time_point start;
+  spans_t spans{};
+
+  std::chrono::microseconds& operator[](const Span span);
+};
+
+struct SpanSummary {
+  QString service;
+  QString operation;
+  Span span = Span::Queue;
+  qsizetype count = 0;
+  std::chrono::microseconds p50{0};
+  std::chrono::microseconds p90{0};
+  std::chrono::microseconds p99{0};
+};
+
+// Keeps the most recent traces, and percentiles of each span over a rolling
+// window of requests.
+class Tracer final {
+public:
+  void add(const Trace& trace);
+
+  QList<SpanSummary> summary() const;
+  QByteArray toJson() const;
+
+private:
+  using key_t = std::pair<QString, QString>;
+  using samples_t = std::array<std::deque<std::chrono::microseconds>, kSpans.size()>;
+
+  QMap<key_t, samples_t> samples_;
+  std::deque<Trace> traces_;
+};
+
+QString spanName(const Span span);
+
+inline Tracer tracer;
+
+}  // namespace sync
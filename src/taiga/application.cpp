@@ -20,6 +20,7 @@
 
 #include <QDir>
 #include <QFileInfo>
+#include <QTimer>
 #include <QTranslator>
 #include <format>
 
@@ -28,11 +29,16 @@
 #include "gui/utils/theme.hpp"
 #include "media/anime_db.hpp"
 #include "media/anime_history.hpp"
+#include "sync/queue.hpp"
+#include "sync/refresher.hpp"
+#include "sync/service.hpp"
 #include "taiga/config.h"
 #include "taiga/path.hpp"
 #include "taiga/settings.hpp"
 #include "taiga/version.hpp"
+#include "track/library.hpp"
 #include "track/media.hpp"
+#include "track/recognition_cache.hpp"
 
 namespace taiga {
 
@@ -73,7 +79,10 @@ int Application::run() {
 
   taiga::settings.init();
   anime::db.init();
+  track::recognition::initCache();
   anime::history.init();
+  sync::queue.init();
+  track::library.scan();
   track::media::detection()->init();
 
   gui::theme.initStyle();
@@ -88,6 +97,11 @@ int Application::run() {
   window_->init();
   window_->show();
 
+  // Connections are set up once the window is up, before they are needed
+  QTimer::singleShot(0, this, []() { sync::preconnect(); });
+
+  sync::refresher.init();
+
   return QApplication::exec();
 }
 
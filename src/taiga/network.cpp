@@ -18,21 +18,44 @@
 
 #include "network.hpp"
 
+#include <QNetworkDiskCache>
 #include <QNetworkReply>
+#include <QSslConfiguration>
+#include <memory>
 
 #include "base/string.hpp"
 #include "taiga/application.hpp"
 #include "taiga/config.h"
+#include "taiga/path.hpp"
 
 namespace taiga {
 
+namespace {
+
+constexpr qint64 kMaxCacheSize = 100 * 1024 * 1024;
+
+QString cacheDirectory() {
+  return u"%1/cache/network"_s.arg(QString::fromStdString(get_data_path()));
+}
+
+}  // namespace
+
 NetworkAccessManager::NetworkAccessManager(QObject* parent) : QNetworkAccessManager{parent} {
   setAutoDeleteReplies(true);
   setTransferTimeout(std::chrono::seconds{10});
 
   // @TODO: Set proxy
 
-  connect(this, &QNetworkAccessManager::finished, this, [](QNetworkReply* reply) {
+  // Responses are stored as the server allows, and stale ones are revalidated
+  // with a conditional request.
+  auto cache = new QNetworkDiskCache(this);
+  cache->setCacheDirectory(cacheDirectory());
+  cache->setMaximumCacheSize(kMaxCacheSize);
+  setCache(cache);
+
+  connect(this, &QNetworkAccessManager::finished, this, [this](QNetworkReply* reply) {
+    updateCacheStats(*reply);
+    updateConnectionStats(*reply);
     if (!app()->isDebug()) return;
     qDebug() << "Response status:"
              << reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
@@ -54,4 +77,77 @@ QHttpHeaders NetworkAccessManager::commonHeaders() {
   return headers;
 }
 
+// Sets up the connection before the first request, so that it does not have to
+// wait for the name lookup and the handshakes. HTTP/2 has to be offered during
+// the TLS handshake, otherwise requests cannot reuse the connection.
+void NetworkAccessManager::preconnect(const QUrl& url) {
+  if (url.scheme() == "https") {
+    auto config = QSslConfiguration::defaultConfiguration();
+    config.setAllowedNextProtocols(
+        {QSslConfiguration::ALPNProtocolHTTP2, QSslConfiguration::ALPNProtocolHTTP1_1});
+    connectToHostEncrypted(url.host(), url.port(443), config);
+  } else {
+    connectToHost(url.host(), url.port(80));
+  }
+}
+
+const NetworkAccessManager::CacheStats& NetworkAccessManager::cacheStats() const {
+  return cache_stats_;
+}
+
+const NetworkAccessManager::ConnectionStats& NetworkAccessManager::connectionStats() const {
+  return connection_stats_;
+}
+
+// Requests that do not start a connection of their own reuse an existing one
+QNetworkReply* NetworkAccessManager::createRequest(Operation op,
+                                                   const QNetworkRequest& originalReq,
+                                                   QIODevice* outgoingData) {
+  const auto reply = QNetworkAccessManager::createRequest(op, originalReq, outgoingData);
+
+  connect(reply, &QNetworkReply::socketStartedConnecting, this,
+          [this]() { connection_stats_.connections += 1; });
+
+  return reply;
+}
+
+void NetworkAccessManager::updateCacheStats(const QNetworkReply& reply) {
+  // Other operations are never served from the cache
+  if (reply.operation() != QNetworkAccessManager::GetOperation) return;
+  if (reply.error() != QNetworkReply::NoError) return;
+
+  // The receiver has usually read the body by now, so its size is taken from
+  // the header, or else from the cached copy.
+  if (reply.attribute(QNetworkRequest::SourceIsFromCacheAttribute).toBool()) {
+    bool ok = false;
+    auto size = reply.header(QNetworkRequest::ContentLengthHeader).toLongLong(&ok);
+    if (!ok) {
+      const std::unique_ptr<QIODevice> data{cache()->data(reply.url())};
+      size = data ? data->size() : 0;
+    }
+    cache_stats_.hits += 1;
+    cache_stats_.bytes_saved += size;
+  } else {
+    cache_stats_.misses += 1;
+  }
+
+  if (!app()->isDebug()) return;
+  qDebug().nospace() << "Cache: " << cache_stats_.hits << " hits, " << cache_stats_.misses
+                     << " misses, " << cache_stats_.bytes_saved << " bytes saved";
+}
+
+void NetworkAccessManager::updateConnectionStats(const QNetworkReply& reply) {
+  if (reply.attribute(QNetworkRequest::SourceIsFromCacheAttribute).toBool()) return;
+
+  connection_stats_.requests += 1;
+  if (reply.attribute(QNetworkRequest::Http2WasUsedAttribute).toBool()) {
+    connection_stats_.http2 += 1;
+  }
+
+  if (!app()->isDebug()) return;
+  qDebug().nospace() << "Connections: " << connection_stats_.requests << " requests, "
+                     << connection_stats_.connections << " new connections, "
+                     << connection_stats_.http2 << " over HTTP/2";
+}
+
 }  // namespace taiga
@@ -21,6 +21,7 @@
 #include <QCoreApplication>
 #include <QHttpHeaders>
 #include <QNetworkAccessManager>
+#include <QUrl>
 
 namespace taiga {
 
@@ -33,6 +34,34 @@ public:
   ~NetworkAccessManager() = default;
 
   static QHttpHeaders commonHeaders();
+
+  void preconnect(const QUrl& url);
+
+  struct CacheStats {
+    int hits = 0;
+    int misses = 0;
+    qint64 bytes_saved = 0;
+  };
+
+  struct ConnectionStats {
+    int requests = 0;
+    int connections = 0;
+    int http2 = 0;
+  };
+
+  const CacheStats& cacheStats() const;
+  const ConnectionStats& connectionStats() const;
+
+protected:
+  QNetworkReply* createRequest(Operation op, const QNetworkRequest& originalReq,
+                               QIODevice* outgoingData) override;
+
+private:
+  void updateCacheStats(const QNetworkReply& reply);
+  void updateConnectionStats(const QNetworkReply& reply);
+
+  CacheStats cache_stats_;
+  ConnectionStats connection_stats_;
 };
 
 inline NetworkAccessManager* network() {
@@ -59,6 +59,11 @@ Qt::ColorScheme Settings::appColorScheme() const {
       .value<Qt::ColorScheme>();
 }
 
+// Memory that decoded posters can take up, in MiB
+int Settings::posterCacheSize() const {
+  return value("app.posterCache.size", 64).toInt();
+}
+
 std::string Settings::service() const {
   return value("v1.service", sync::serviceSlug(sync::ServiceId::AniList)).toString().toStdString();
 }
@@ -69,17 +74,43 @@ std::vector<std::string> Settings::libraryFolders() const {
          std::ranges::to<std::vector>();
 }
 
+// Maximum number of file system operations per second, where 0 means no limit
+int Settings::libraryCrawlRate() const {
+  return value("library.crawl.rate", 0).toInt();
+}
+
 std::chrono::milliseconds Settings::mediaDetectionInterval() const {
   const auto interval = value("track.detection.interval", 3000).toInt();
   return std::chrono::milliseconds{interval};
 }
 
+// Time to wait after the last change before the queue is sent, long enough for
+// the next episode of a series to be watched in the meantime
+std::chrono::seconds Settings::syncQueueDelay() const {
+  const auto delay = value("sync.queue.delay", 30 * 60).toInt();
+  return std::chrono::seconds{delay};
+}
+
+// Number of requests per hour that can be made to refresh stale metadata
+int Settings::syncRefreshBudget() const {
+  return value("sync.refresh.budget", 20).toInt();
+}
+
+// Can be pointed at a local server for testing
+std::string Settings::anilistApiUrl() const {
+  return value("sync.anilist.apiUrl", "https://graphql.anilist.co").toString().toStdString();
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 void Settings::setAppColorScheme(const Qt::ColorScheme scheme) const {
   setValue("app.colorScheme", static_cast<int>(scheme));
 }
 
+void Settings::setPosterCacheSize(const int size) const {
+  setValue("app.posterCache.size", size);
+}
+
 void Settings::setService(const std::string& service) const {
   setValue("v1.service", service);
 }
@@ -92,8 +123,24 @@ void Settings::setLibraryFolders(std::vector<std::string> folders) const {
   setValue("library.folders", QJsonArray::fromStringList(list));
 }
 
+void Settings::setLibraryCrawlRate(const int rate) const {
+  setValue("library.crawl.rate", rate);
+}
+
 void Settings::setMediaDetectionInterval(const std::chrono::milliseconds interval) const {
   setValue("track.detection.interval", interval.count());
 }
 
+void Settings::setSyncQueueDelay(const std::chrono::seconds delay) const {
+  setValue("sync.queue.delay", delay.count());
+}
+
+void Settings::setSyncRefreshBudget(const int requests) const {
+  setValue("sync.refresh.budget", requests);
+}
+
+void Settings::setAnilistApiUrl(const std::string& url) const {
+  setValue("sync.anilist.apiUrl", url);
+}
+
 }  // namespace taiga
@@ -31,14 +31,24 @@ public:
   void init() const;
 
   Qt::ColorScheme appColorScheme() const;
+  int posterCacheSize() const;
   std::string service() const;
   std::vector<std::string> libraryFolders() const;
+  int libraryCrawlRate() const;
   std::chrono::milliseconds mediaDetectionInterval() const;
+  std::chrono::seconds syncQueueDelay() const;
+  int syncRefreshBudget() const;
+  std::string anilistApiUrl() const;
 
   void setAppColorScheme(const Qt::ColorScheme scheme) const;
+  void setPosterCacheSize(const int size) const;
   void setService(const std::string& service) const;
   void setLibraryFolders(std::vector<std::string> folders) const;
+  void setLibraryCrawlRate(const int rate) const;
   void setMediaDetectionInterval(const std::chrono::milliseconds interval) const;
+  void setSyncQueueDelay(const std::chrono::seconds delay) const;
+  void setSyncRefreshBudget(const int requests) const;
+  void setAnilistApiUrl(const std::string& url) const;
 
 private:
   QString fileName() const override;
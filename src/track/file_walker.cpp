@@ -0,0 +1,88 @@
+/**
+ * Taiga
+ * Copyright (C) 2010-2025, Eren Okka
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "file_walker.hpp"
+
+#include <QDir>
+#include <QDirIterator>
+#include <QFileInfo>
+#include <QStringList>
+#include <string>
+
+#ifdef Q_OS_LINUX
+#include "track/platforms/linux.hpp"
+#endif
+
+namespace track {
+
+bool QtFileWalker::walk(std::string_view root, const WalkOptions& options,
+                        const walk_callback_t& callback) {
+  const auto rootPath = QDir::cleanPath(QString::fromUtf8(root.data(), root.size()));
+
+  if (!QFileInfo{rootPath}.isDir()) return false;
+
+  QStringList pending{rootPath};
+
+  while (!pending.isEmpty()) {
+    const auto path = pending.takeLast();
+    const auto directory = path.toStdString();
+
+    QDirIterator it{path, QDir::Dirs | QDir::Files | QDir::NoDotAndDotDot};
+
+    while (it.hasNext()) {
+      const auto info = it.nextFileInfo();
+      const auto name = info.fileName().toStdString();
+
+      if (options.stat && options.before_stat) options.before_stat();
+
+      const FileEntry entry{
+          .directory = directory,
+          .name = name,
+          .is_directory = info.isDir(),
+          .is_symlink = info.isSymLink(),
+          .size = options.stat ? static_cast<std::uint64_t>(info.size()) : 0,
+          .last_modified = options.stat ? info.lastModified().toSecsSinceEpoch() : 0,
+      };
+
+      switch (callback(entry)) {
+        case WalkResult::Continue:
+          break;
+        case WalkResult::SkipDirectory:
+          continue;
+        case WalkResult::Stop:
+          return true;
+      }
+
+      if (entry.is_directory && options.recursive && !entry.is_symlink) {
+        pending.append(info.filePath());
+      }
+    }
+  }
+
+  return true;
+}
+
+std::unique_ptr<FileWalker> createFileWalker() {
+#ifdef Q_OS_LINUX
+  return std::make_unique<LinuxFileWalker>();
+#else
+  return std::make_unique<QtFileWalker>();
+#endif
+}
+
+}  // namespace track
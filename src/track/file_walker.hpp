@@ -0,0 +1,74 @@
+/**
+ * Taiga
+ * Copyright (C) 2010-2025, Eren Okka
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string_view>
+
+namespace track {
+
+struct FileEntry {
+  std::string_view directory;  // parent directory, without a trailing separator
+  std::string_view name;
+  bool is_directory = false;
+  bool is_symlink = false;         // `is_directory` tells what the link points to
+  std::uint64_t size = 0;          // only available with `WalkOptions::stat`
+  std::int64_t last_modified = 0;  // only available with `WalkOptions::stat`
+};
+
+enum class WalkResult {
+  Continue,
+  SkipDirectory,  // do not descend into the directory that was just visited
+  Stop,
+};
+
+struct WalkOptions {
+  bool recursive = true;
+  bool stat = false;
+  // Called before each metadata operation on an entry, so that callers can
+  // limit the rate of operations on slow devices
+  std::function<void()> before_stat;
+};
+
+using walk_callback_t = std::function<WalkResult(const FileEntry& entry)>;
+
+class FileWalker {
+public:
+  virtual ~FileWalker() = default;
+
+  // Visits every entry under `root`, skipping hidden entries. All entries of a
+  // directory are visited before any of its subdirectories are descended into,
+  // most recently found first. The views in `FileEntry` are only valid for the
+  // duration of the callback.
+  virtual bool walk(std::string_view root, const WalkOptions& options,
+                    const walk_callback_t& callback) = 0;
+};
+
+class QtFileWalker final : public FileWalker {
+public:
+  bool walk(std::string_view root, const WalkOptions& options,
+            const walk_callback_t& callback) override;
+};
+
+// Returns the fastest walker available on the current platform
+std::unique_ptr<FileWalker> createFileWalker();
+
+}  // namespace track
@@ -0,0 +1,382 @@
+/**
+ * Taiga
+ * Copyright (C) 2010-2025, Eren Okka
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "library.hpp"
+
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QFileInfo>
+#include <QThreadPool>
+#include <bit>
+#include <charconv>
+#include <format>
+
+#include "base/file.hpp"
+#include "base/string.hpp"
+#include "media/anime.hpp"
+#include "taiga/path.hpp"
+#include "taiga/settings.hpp"
+#include "track/episode.hpp"
+#include "track/file_walker.hpp"
+#include "track/library_crawler.hpp"
+#include "track/recognition.hpp"
+#include "track/recognition_cache.hpp"
+#include "track/scanner.hpp"
+
+namespace {
+
+// Verification is bound by disk throughput, so reading too many files at once
+// would only cause seeking on hard drives and congestion on network shares.
+constexpr int kMaxConcurrentReads = 2;
+
+QString databaseFileName() {
+  return u"%1/library.sqlite"_s.arg(QString::fromStdString(taiga::get_data_path()));
+}
+
+// Filenames such as "01.mkv" give us nothing but what the folder provides
+bool hasPoorTitle(const track::FileEntry& entry, const track::Episode& episode) {
+  const auto title = episode.element(anitomy::ElementKind::Title);
+  if (title.empty()) return true;
+  const auto pos = entry.directory.find_last_of('/');
+  const auto dirName =
+      pos != std::string_view::npos ? entry.directory.substr(pos + 1) : entry.directory;
+  return title == dirName;
+}
+
+// Container duration rules out matches of a different kind, such as a movie for
+// a TV episode. The margin is wide, because the length may be an estimate.
+bool isValidLength(const track::recognition::Cache& cache, const int id,
+                   const track::MediaInfo& info) {
+  const auto item = cache.item(id);
+  if (!item || info.duration.count() <= 0) return true;
+
+  const auto minutes = std::chrono::duration_cast<std::chrono::minutes>(info.duration).count();
+  const int length = item->episode_length;
+
+  return minutes >= length / 3 && minutes <= length * 3;
+}
+
+}  // namespace
+
+namespace track {
+
+int EpisodeAvailability::size() const {
+  return size_;
+}
+
+int EpisodeAvailability::count() const {
+  return count_;
+}
+
+bool EpisodeAvailability::contains(const int number) const {
+  if (number < 1 || number > size_) return false;
+  const auto index = static_cast<size_t>(number - 1);
+  return (bits_[index / 64] >> (index % 64)) & 1;
+}
+
+// Returns the first available episode after `number`, or `0` if there is none
+int EpisodeAvailability::next(const int number) const {
+  const auto index = static_cast<size_t>(std::max(number, 0));
+  if (index >= static_cast<size_t>(size_)) return 0;
+
+  auto word = index / 64;
+  auto bits = bits_[word] & (~std::uint64_t{0} << (index % 64));
+
+  while (!bits) {
+    if (++word == bits_.size()) return 0;
+    bits = bits_[word];
+  }
+
+  return static_cast<int>(word * 64 + std::countr_zero(bits)) + 1;
+}
+
+void EpisodeAvailability::insert(const int number) {
+  if (number < 1 || number > kMaxSize) return;
+  if (number > size_) resize(number);
+
+  const auto index = static_cast<size_t>(number - 1);
+  const auto mask = std::uint64_t{1} << (index % 64);
+  auto& word = bits_[index / 64];
+
+  if (!(word & mask)) {
+    word |= mask;
+    ++count_;
+  }
+}
+
+// Bitsets only grow, so that no availability information is lost
+void EpisodeAvailability::resize(const int size) {
+  if (size <= size_ || size > kMaxSize) return;
+  size_ = size;
+  bits_.resize((static_cast<size_t>(size) + 63) / 64);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+Library::Library() : QObject{} {
+  verify_pool_.setMaxThreadCount(kMaxConcurrentReads);
+}
+
+void Library::scan() {
+  if (scanning_) return;
+
+  scanning_ = true;
+  cancelled_ = false;
+
+  connect(qApp, &QCoreApplication::aboutToQuit, this, &Library::cancelScan,
+          Qt::UniqueConnection);
+
+  QThreadPool::globalInstance()->start([this, folders = taiga::settings.libraryFolders(),
+                                        crawlRate = taiga::settings.libraryCrawlRate(),
+                                        probes = probes_, cache = recognition::cache()]() mutable {
+    auto index = buildIndex(folders, crawlRate, std::move(probes), std::move(cache));
+    QMetaObject::invokeMethod(
+        this,
+        [this, index = std::move(index)]() mutable {
+          // An interrupted scan continues from its checkpoint the next time
+          if (index.is_complete) {
+            items_ = std::move(index.items);
+            probes_ = std::move(index.probes);
+          }
+          scanning_ = false;
+          emit scanFinished();
+        },
+        Qt::QueuedConnection);
+  });
+}
+
+void Library::cancelScan() {
+  cancelled_ = true;
+}
+
+bool Library::isScanning() const {
+  return scanning_;
+}
+
+const Library::Item* Library::item(const int id) const {
+  const auto it = items_.find(id);
+  return it != items_.end() ? &(*it) : nullptr;
+}
+
+bool Library::isAvailable(const int id, const int number) const {
+  const auto item = this->item(id);
+  return item && item->episodes.contains(number);
+}
+
+int Library::nextAvailable(const int id, const int number) const {
+  const auto item = this->item(id);
+  return item ? item->episodes.next(number) : 0;
+}
+
+int Library::countAvailable(const int id) const {
+  const auto item = this->item(id);
+  return item ? item->episodes.count() : 0;
+}
+
+std::optional<QString> Library::episodePath(const int id, const int number) const {
+  const auto item = this->item(id);
+  if (!item) return std::nullopt;
+
+  const auto it = item->paths.find(number);
+  if (it == item->paths.end()) return std::nullopt;
+
+  return QString::fromStdString(it->second);
+}
+
+// Compares files against the checksum in their name (e.g. "[1A2B3C4D]")
+void Library::verify(const QString& path) {
+  verify_pool_.start([this, path]() {
+    QList<ChecksumFile> files;
+
+    const auto addFile = [&files](std::string_view directory, std::string_view name) {
+      const auto episode = recognition::parse(name);
+      const auto checksum = episode.element(anitomy::ElementKind::FileChecksum);
+      if (checksum.size() != 8) return;
+      ChecksumFile file{.path = QString::fromStdString(std::format("{}/{}", directory, name))};
+      const auto [_, ec] =
+          std::from_chars(checksum.data(), checksum.data() + checksum.size(), file.checksum, 16);
+      if (ec == std::errc{}) files.push_back(std::move(file));
+    };
+
+    if (const QFileInfo info{path}; info.isFile()) {
+      addFile(info.path().toStdString(), info.fileName().toStdString());
+    } else {
+      createFileWalker()->walk(path.toStdString(), {}, [&addFile](const FileEntry& entry) {
+        if (!entry.is_directory) addFile(entry.directory, entry.name);
+        return WalkResult::Continue;
+      });
+    }
+
+    QMetaObject::invokeMethod(
+        this, [this, path, files]() { verifyFiles(path, files); }, Qt::QueuedConnection);
+  });
+}
+
+// Files are read on the same pool, and results are counted as they come in
+void Library::verifyFiles(const QString& path, const QList<ChecksumFile>& files) {
+  if (files.isEmpty()) {
+    emit verificationFinished(path, 0, {});
+    return;
+  }
+
+  struct Verification {
+    qsizetype remaining = 0;
+    QStringList failed;
+  };
+
+  const auto verification = std::make_shared<Verification>(Verification{.remaining = files.size()});
+
+  for (const auto& file : files) {
+    verify_pool_.start([this, path, file, count = files.size(), verification]() {
+      const auto crc = base::crc32File(file.path);
+      const auto state = !crc                    ? ChecksumState::Unreadable
+                         : *crc == file.checksum ? ChecksumState::Valid
+                                                 : ChecksumState::Invalid;
+
+      QMetaObject::invokeMethod(
+          this,
+          [this, path, file, count, verification, state]() {
+            checksums_[file.path] = state;
+            if (state != ChecksumState::Valid) verification->failed.push_back(file.path);
+            if (--verification->remaining > 0) return;
+            emit verificationFinished(path, static_cast<int>(count), verification->failed);
+          },
+          Qt::QueuedConnection);
+    });
+  }
+}
+
+ChecksumState Library::checksumState(const QString& path) const {
+  return checksums_.value(path, ChecksumState::Unknown);
+}
+
+const MediaInfo* Library::mediaInfo(const QString& path) const {
+  const auto it = probes_.find(path.toStdString());
+  if (it == probes_.end() || !it->second.info) return nullptr;
+  return &*it->second.info;
+}
+
+Library::Index Library::buildIndex(const std::vector<std::string>& folders, const int crawlRate,
+                                   probes_t probes,
+                                   std::shared_ptr<const recognition::Cache> cache) {
+  Index index;
+  auto& items = index.items;
+
+  LibraryCrawler crawler{databaseFileName(), crawlRate, cancelled_};
+
+  // Container headers are only read for files with poor names, and only once
+  // for as long as their size and modification time stay the same. Both count
+  // towards the crawl rate.
+  const auto probe = [&probes, &index, &crawler](const std::string& path) -> const auto& {
+    crawler.acquire();
+    const QFileInfo info{QString::fromStdString(path)};
+    Probe result{.size = info.size(), .last_modified = info.lastModified().toSecsSinceEpoch()};
+
+    const auto it = probes.find(path);
+    if (it != probes.end() && it->second.size == result.size &&
+        it->second.last_modified == result.last_modified) {
+      result.info = std::move(it->second.info);
+    } else {
+      crawler.acquire();
+      result.info = probeMediaFile(info.filePath());
+    }
+
+    return index.probes.insert_or_assign(path, std::move(result)).first->second.info;
+  };
+
+  Scanner scanner{std::move(cache)};
+
+  const auto callback = [&items, &scanner, &probe](const FileEntry& entry) {
+    if (entry.is_directory) {
+      scanner.scanDirectory(entry);
+      return WalkResult::Continue;
+    }
+
+    auto episode = scanner.parseFile(entry);
+
+    // Skip files that are not recognized as videos (e.g. subtitles)
+    if (!episode.contains(anitomy::ElementKind::FileExtension)) return WalkResult::Continue;
+
+    const auto path = std::format("{}/{}", entry.directory, entry.name);
+    const bool has_poor_title = hasPoorTitle(entry, episode);
+
+    int id = scanner.identifyFile(entry, episode);
+
+    if (has_poor_title) {
+      if (const auto& info = probe(path)) {
+        if (id != anime::kUnknownId && !isValidLength(scanner.cache(), id, *info)) {
+          id = anime::kUnknownId;
+        }
+
+        // The container title often has what the filename lacks
+        if (id == anime::kUnknownId && !info->title.empty()) {
+          auto container = recognition::parse(info->title);
+          if (container.contains(anitomy::ElementKind::Title)) {
+            if (!container.contains(anitomy::ElementKind::Episode) &&
+                episode.contains(anitomy::ElementKind::Episode)) {
+              container.addElement(anitomy::ElementKind::Episode,
+                                   episode.element(anitomy::ElementKind::Episode));
+            }
+            container.addElement(anitomy::ElementKind::FileExtension,
+                                 episode.element(anitomy::ElementKind::FileExtension));
+            id = recognition::identify(scanner.cache(), container);
+            if (id != anime::kUnknownId && isValidLength(scanner.cache(), id, *info)) {
+              episode = std::move(container);
+            } else {
+              id = anime::kUnknownId;
+            }
+          }
+        }
+      }
+    }
+
+    if (id == anime::kUnknownId) return WalkResult::Continue;
+
+    const auto anime = scanner.cache().item(id);
+
+    int number = QString::fromStdString(episode.element(anitomy::ElementKind::Episode)).toInt();
+    if (!number && anime && anime->episode_count == 1) number = 1;
+    if (number < 1) return WalkResult::Continue;
+
+    // Numbers beyond the episode count are most likely something else, such as a
+    // year or a resolution.
+    if (anime && anime->episode_count > 0 && number > anime->episode_count) {
+      return WalkResult::Continue;
+    }
+    if (number > EpisodeAvailability::kMaxSize) return WalkResult::Continue;
+
+    auto& item = items[id];
+    if (anime && anime->episode_count > 0) item.episodes.resize(anime->episode_count);
+    item.episodes.insert(number);
+    item.paths.try_emplace(number, path);
+
+    return WalkResult::Continue;
+  };
+
+  const auto progress = [this](int folders, int files) {
+    QMetaObject::invokeMethod(
+        this, [this, folders, files]() { emit scanProgress(folders, files); },
+        Qt::QueuedConnection);
+  };
+
+  index.is_complete = crawler.crawl(folders, callback, progress);
+
+  return index;
+}
+
+}  // namespace track
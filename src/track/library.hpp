@@ -0,0 +1,142 @@
+/**
+ * Taiga
+ * Copyright (C) 2010-2025, Eren Okka
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QHash>
+#include <QMap>
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QThreadPool>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "track/media_probe.hpp"
+
+namespace track {
+
+namespace recognition {
+class Cache;
+}
+
+// A bitset where bit `n - 1` tells whether episode `n` is available on disk.
+// It is sized by the episode count when known, and grows as needed otherwise,
+// up to a fixed limit.
+class EpisodeAvailability final {
+public:
+  static constexpr int kMaxSize = 10'000;
+
+  int size() const;
+  int count() const;
+
+  bool contains(const int number) const;
+  int next(const int number) const;
+
+  void insert(const int number);
+  void resize(const int size);
+
+private:
+  std::vector<std::uint64_t> bits_;
+  int size_ = 0;
+  int count_ = 0;
+};
+
+enum class ChecksumState {
+  Unknown,
+  Valid,
+  Invalid,
+  Unreadable,
+};
+
+class Library final : public QObject {
+  Q_OBJECT
+  Q_DISABLE_COPY_MOVE(Library)
+
+public:
+  struct Item {
+    EpisodeAvailability episodes;
+    std::unordered_map<int, std::string> paths;
+  };
+
+  Library();
+  ~Library() = default;
+
+  void scan();
+  void cancelScan();
+  bool isScanning() const;
+
+  const Item* item(const int id) const;
+
+  bool isAvailable(const int id, const int number) const;
+  int nextAvailable(const int id, const int number) const;
+  int countAvailable(const int id) const;
+  std::optional<QString> episodePath(const int id, const int number) const;
+
+  void verify(const QString& path);
+  ChecksumState checksumState(const QString& path) const;
+
+  const MediaInfo* mediaInfo(const QString& path) const;
+
+signals:
+  void scanProgress(int folders, int files);
+  void scanFinished();
+  void verificationFinished(const QString& path, int count, const QStringList& failed);
+
+private:
+  // Probe results are kept for as long as the file stays the same
+  struct Probe {
+    std::int64_t size = 0;
+    std::int64_t last_modified = 0;
+    std::optional<MediaInfo> info;
+  };
+
+  using probes_t = std::unordered_map<std::string, Probe>;
+
+  struct ChecksumFile {
+    QString path;
+    std::uint32_t checksum = 0;
+  };
+
+  struct Index {
+    QMap<int, Item> items;
+    probes_t probes;
+    bool is_complete = false;
+  };
+
+  void verifyFiles(const QString& path, const QList<ChecksumFile>& files);
+
+  Index buildIndex(const std::vector<std::string>& folders, const int crawlRate,
+                   probes_t probes, std::shared_ptr<const recognition::Cache> cache);
+
+  QMap<int, Item> items_;
+  probes_t probes_;
+  QHash<QString, ChecksumState> checksums_;
+  QThreadPool verify_pool_;
+  bool scanning_ = false;
+  std::atomic_bool cancelled_ = false;
+};
+
+inline Library library;
+
+}  // namespace track
@@ -0,0 +1,318 @@
+/**
+ * Taiga
+ * Copyright (C) 2010-2025, Eren Okka
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "library_crawler.hpp"
+
+#include <QDateTime>
+#include <QFileInfo>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <algorithm>
+#include <chrono>
+#include <format>
+#include <ranges>
+#include <thread>
+#include <unordered_map>
+
+#include "base/file.hpp"
+#include "base/log.hpp"
+#include "base/string.hpp"
+
+namespace track {
+
+namespace {
+
+constexpr auto kConnectionName = "library";
+constexpr auto kCommitInterval = std::chrono::seconds{1};
+constexpr auto kProgressInterval = std::chrono::milliseconds{100};
+
+// Listings of earlier versions may include symbolic links to directories
+constexpr int kCheckpointVersion = 2;
+
+using steady_clock_t = std::chrono::steady_clock;
+
+struct Folder {
+  std::int64_t last_modified = 0;
+  std::int64_t crawl = 0;
+  std::vector<std::pair<std::string, bool>> entries;  // name, is directory
+};
+
+QString sql(const QString& name) {
+  return base::readFile(u":/sql/%1.sql"_s.arg(name));
+}
+
+class Checkpoint final {
+public:
+  explicit Checkpoint(QSqlDatabase& db) : db_{db} {
+    const auto tables = db_.tables();
+    QSqlQuery q{db_};
+    if (!tables.contains("meta")) q.exec(sql("createMeta"));
+    if (!tables.contains("library_folder")) q.exec(sql("createLibraryFolder"));
+    if (!tables.contains("library_entry")) q.exec(sql("createLibraryEntry"));
+
+    if (readMeta("checkpoint_version") != kCheckpointVersion) {
+      q.exec("DELETE FROM library_folder");
+      q.exec("DELETE FROM library_entry");
+      writeMeta("checkpoint_version", kCheckpointVersion);
+    }
+  }
+
+  std::int64_t readMeta(const QString& name) const {
+    QSqlQuery q{db_};
+    if (!q.prepare("SELECT value FROM meta WHERE name = :name")) return 0;
+    q.bindValue(":name", name);
+    return q.exec() && q.next() ? q.value(0).toLongLong() : 0;
+  }
+
+  void writeMeta(const QString& name, const std::int64_t value) const {
+    QSqlQuery q{db_};
+    q.prepare("DELETE FROM meta WHERE name = :name");
+    q.bindValue(":name", name);
+    q.exec();
+    q.prepare("INSERT INTO meta(name, value) VALUES(:name, :value)");
+    q.bindValue(":name", name);
+    q.bindValue(":value", value);
+    q.exec();
+  }
+
+  std::unordered_map<std::string, Folder> readFolders() const {
+    std::unordered_map<std::string, Folder> folders;
+
+    QSqlQuery q{db_};
+    q.setForwardOnly(true);
+
+    if (q.exec("SELECT path, last_modified, crawl FROM library_folder")) {
+      while (q.next()) {
+        folders[q.value(0).toString().toStdString()] = {.last_modified = q.value(1).toLongLong(),
+                                                        .crawl = q.value(2).toLongLong()};
+      }
+    }
+
+    if (q.exec("SELECT folder, name, directory FROM library_entry")) {
+      while (q.next()) {
+        const auto it = folders.find(q.value(0).toString().toStdString());
+        if (it == folders.end()) continue;
+        it->second.entries.emplace_back(q.value(1).toString().toStdString(), q.value(2).toBool());
+      }
+    }
+
+    return folders;
+  }
+
+  void writeFolder(const std::string& path, const Folder& folder) const {
+    const auto folderPath = QString::fromStdString(path);
+
+    QSqlQuery q{db_};
+    q.prepare(
+        "INSERT OR REPLACE INTO library_folder(path, last_modified, crawl) "
+        "VALUES(:path, :last_modified, :crawl)");
+    q.bindValue(":path", folderPath);
+    q.bindValue(":last_modified", folder.last_modified);
+    q.bindValue(":crawl", folder.crawl);
+    q.exec();
+
+    q.prepare("DELETE FROM library_entry WHERE folder = :folder");
+    q.bindValue(":folder", folderPath);
+    q.exec();
+
+    if (folder.entries.empty()) return;
+
+    QVariantList folders;
+    QVariantList names;
+    QVariantList directories;
+    for (const auto& [name, is_directory] : folder.entries) {
+      folders.push_back(folderPath);
+      names.push_back(QString::fromStdString(name));
+      directories.push_back(is_directory);
+    }
+
+    q.prepare("INSERT INTO library_entry(folder, name, directory) VALUES(?, ?, ?)");
+    q.addBindValue(folders);
+    q.addBindValue(names);
+    q.addBindValue(directories);
+    q.execBatch();
+  }
+
+  void touchFolder(const std::string& path, const std::int64_t crawl) const {
+    QSqlQuery q{db_};
+    q.prepare("UPDATE library_folder SET crawl = :crawl WHERE path = :path");
+    q.bindValue(":crawl", crawl);
+    q.bindValue(":path", QString::fromStdString(path));
+    q.exec();
+  }
+
+  // Removes folders that were not seen during a completed crawl
+  void purge(const std::int64_t crawl) const {
+    QSqlQuery q{db_};
+    q.prepare("DELETE FROM library_folder WHERE crawl != :crawl");
+    q.bindValue(":crawl", crawl);
+    q.exec();
+    q.exec("DELETE FROM library_entry WHERE folder NOT IN (SELECT path FROM library_folder)");
+  }
+
+private:
+  QSqlDatabase& db_;
+};
+
+}  // namespace
+
+LibraryCrawler::LibraryCrawler(const QString& fileName, const int maxOperationsPerSecond,
+                               const std::atomic_bool& cancelled)
+    : fileName_{fileName},
+      cancelled_{cancelled},
+      interval_{maxOperationsPerSecond > 0
+                    ? std::chrono::nanoseconds{std::chrono::seconds{1}} / maxOperationsPerSecond
+                    : std::chrono::nanoseconds::zero()} {}
+
+// Spaces out operations evenly, so that bursts do not saturate slow devices
+void LibraryCrawler::acquire() {
+  if (interval_ == interval_.zero()) return;
+  const auto now = steady_clock_t::now();
+  if (next_ > now) std::this_thread::sleep_until(next_);
+  next_ = std::max(now, next_) + interval_;
+}
+
+bool LibraryCrawler::crawl(const std::vector<std::string>& roots, const walk_callback_t& callback,
+                           const progress_callback_t& progress) {
+  bool isFinished = false;
+
+  // Connections cannot be shared between threads, so the crawler has its own
+  {
+    auto db = QSqlDatabase::addDatabase("QSQLITE", kConnectionName);
+    db.setDatabaseName(fileName_);
+
+    if (!db.open()) {
+      LOGW("Could not open library database: {}", fileName_.toStdString());
+      const auto walker = createFileWalker();
+      for (const auto& root : roots) {
+        walker->walk(root, {}, callback);
+      }
+      isFinished = !cancelled_;
+    } else {
+      const Checkpoint checkpoint{db};
+      const auto walker = createFileWalker();
+      const WalkOptions options{.recursive = false, .before_stat = [this]() { acquire(); }};
+
+      auto folders = checkpoint.readFolders();
+
+      // Each crawl has a number. Folders that already have the current number
+      // were visited before the crawl was interrupted.
+      auto crawl = checkpoint.readMeta("crawl");
+      if (!crawl || checkpoint.readMeta("crawl_finished")) {
+        checkpoint.writeMeta("crawl", ++crawl);
+        checkpoint.writeMeta("crawl_finished", 0);
+      }
+
+      int folderCount = 0;
+      int fileCount = 0;
+      bool isStopped = false;
+      auto lastCommit = steady_clock_t::now();
+      auto lastProgress = steady_clock_t::now();
+
+      std::vector<std::string> stack{roots.rbegin(), roots.rend()};
+
+      db.transaction();
+
+      while (!stack.empty()) {
+        if (cancelled_) {
+          isStopped = true;
+          break;
+        }
+
+        const auto path = std::move(stack.back());
+        stack.pop_back();
+
+        auto it = folders.find(path);
+
+        if (it == folders.end() || it->second.crawl != crawl) {
+          acquire();
+          const QFileInfo info{QString::fromStdString(path)};
+          if (!info.isDir()) continue;
+          const auto lastModified = info.lastModified().toMSecsSinceEpoch();
+
+          if (it != folders.end() && it->second.last_modified == lastModified) {
+            it->second.crawl = crawl;
+            checkpoint.touchFolder(path, crawl);
+          } else {
+            Folder folder{.last_modified = lastModified, .crawl = crawl};
+            acquire();
+            const bool isListed =
+                walker->walk(path, options, [&folder](const FileEntry& entry) {
+                  // Links may point back up the tree, so they are not followed
+                  if (entry.is_directory && entry.is_symlink) return WalkResult::Continue;
+                  folder.entries.emplace_back(std::string{entry.name}, entry.is_directory);
+                  return WalkResult::Continue;
+                });
+            if (!isListed) continue;
+            checkpoint.writeFolder(path, folder);
+            it = folders.insert_or_assign(path, std::move(folder)).first;
+          }
+        }
+
+        std::vector<std::string> subfolders;
+
+        for (const auto& [name, is_directory] : it->second.entries) {
+          const FileEntry entry{.directory = path, .name = name, .is_directory = is_directory};
+          const auto result = callback(entry);
+          if (result == WalkResult::Stop) {
+            isStopped = true;
+            break;
+          }
+          if (!is_directory) {
+            ++fileCount;
+          } else if (result == WalkResult::Continue) {
+            subfolders.push_back(std::format("{}/{}", path, name));
+          }
+        }
+
+        if (isStopped) break;
+
+        stack.append_range(subfolders | std::views::reverse);
+        ++folderCount;
+
+        const auto now = steady_clock_t::now();
+        if (now - lastCommit >= kCommitInterval) {
+          db.commit();
+          db.transaction();
+          lastCommit = now;
+        }
+        if (progress && now - lastProgress >= kProgressInterval) {
+          progress(folderCount, fileCount);
+          lastProgress = now;
+        }
+      }
+
+      if (!isStopped) {
+        checkpoint.purge(crawl);
+        checkpoint.writeMeta("crawl_finished", 1);
+        isFinished = true;
+      }
+
+      db.commit();
+      db.close();
+
+      if (progress) progress(folderCount, fileCount);
+    }
+  }
+
+  QSqlDatabase::removeDatabase(kConnectionName);
+
+  return isFinished;
+}
+
+}  // namespace track
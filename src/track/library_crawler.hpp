@@ -0,0 +1,62 @@
+/**
+ * Taiga
+ * Copyright (C) 2010-2025, Eren Okka
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QString>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "track/file_walker.hpp"
+
+namespace track {
+
+// Walks library folders one directory at a time, keeping a checkpoint of the
+// directories it has visited and their modification times in a database.
+//
+// Directories that have not changed since the last crawl are not listed again.
+// Their entries are read from the checkpoint instead, which costs a single
+// metadata operation per directory. A crawl that is cancelled or interrupted
+// continues where it left off the next time.
+class LibraryCrawler final {
+public:
+  using progress_callback_t = std::function<void(int folders, int files)>;
+
+  LibraryCrawler(const QString& fileName, const int maxOperationsPerSecond,
+                 const std::atomic_bool& cancelled);
+
+  // Entries are reported in the same order as with `FileWalker`. Returns false
+  // if the crawl was cancelled before it could finish.
+  bool crawl(const std::vector<std::string>& roots, const walk_callback_t& callback,
+             const progress_callback_t& progress);
+
+  // Waits until the crawl rate allows another file system operation. Callbacks
+  // call it before the operations of their own, so that these count as well.
+  void acquire();
+
+private:
+  QString fileName_;
+  const std::atomic_bool& cancelled_;
+  std::chrono::nanoseconds interval_;
+  std::chrono::steady_clock::time_point next_;
+};
+
+}  // namespace track
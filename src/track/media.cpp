@@ -18,17 +18,265 @@
 
 #include "media.hpp"
 
+#include <QFileInfo>
+#include <QSocketNotifier>
+#include <QTimer>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+
 #include "base/file.hpp"
 #include "media/anime_db.hpp"
 #include "taiga/settings.hpp"
 #include "track/episode.hpp"
 #include "track/recognition.hpp"
 
+#if defined(Q_OS_WINDOWS)
+#include "track/platforms/windows.hpp"
+#elif defined(Q_OS_LINUX)
+#include "track/platforms/linux.hpp"
+#endif
+
 namespace track::media {
 
-Detection::Detection(QObject* parent) : QObject(parent) {
-  pollTimer_ = new QTimer(this);
-  connect(pollTimer_, &QTimer::timeout, this, &Detection::poll);
+namespace {
+
+// Polls are more frequent for a while after something changes, and less
+// frequent while nothing is playing, up to a multiple of the interval.
+constexpr int kFastPollCount = 3;
+constexpr int kFastPollDivisor = 3;
+constexpr int kMaxBackoff = 8;
+
+// Players need a moment to open a file after they are started
+constexpr auto kWakeDelay = std::chrono::milliseconds{500};
+
+struct Result {
+  Detection::player_t player;
+  std::uint32_t process_id = 0;
+  Detection::media_t media;
+};
+
+#ifdef Q_OS_WINDOWS
+std::optional<Result> findMedia(const std::vector<Detection::player_t>& players) {
+  static const auto media_proc = [](const anisthesia::MediaInfo&) {
+    return true;  // Accept all media
+  };
+
+  std::vector<anisthesia::win::Result> results;
+  if (!anisthesia::win::GetResults(players, media_proc, results)) return std::nullopt;
+  if (results.empty()) return std::nullopt;
+
+  const auto& result = results.front();
+  if (result.media.empty() || result.media.front().information.empty()) return std::nullopt;
+
+  return Result{
+      .player = result.player,
+      .process_id = static_cast<std::uint32_t>(result.process.id),
+      .media = result.media.front(),
+  };
+}
+#endif
+
+#ifdef Q_OS_LINUX
+std::optional<Result> findMedia(const std::vector<Detection::player_t>& players,
+                                LinuxProcessScanner& scanner) {
+  const auto results = scanner.scan();
+  if (results.empty()) return std::nullopt;
+
+  const auto& result = results.front();
+
+  anisthesia::MediaInfo info;
+  info.type = anisthesia::MediaInfoType::File;
+  info.value = result.path;
+
+  Detection::media_t media;
+  media.information.push_back(std::move(info));
+
+  return Result{
+      .player = players[result.player],
+      .process_id = result.pid,
+      .media = std::move(media),
+  };
+}
+#endif
+
+bool isSameEpisode(const std::optional<Episode>& a, const std::optional<Episode>& b) {
+  if (!a || !b) return !a && !b;
+  if (a->animeId() != b->animeId()) return false;
+  if (a->element(anitomy::ElementKind::Episode) != b->element(anitomy::ElementKind::Episode)) {
+    return false;
+  }
+  return a->element(anitomy::ElementKind::Title) == b->element(anitomy::ElementKind::Title);
+}
+
+}  // namespace
+
+class DetectionWorker final : public QObject {
+public:
+  DetectionWorker(Detection* detection, std::vector<Detection::player_t> players)
+      : QObject{}, detection_{detection}, players_{std::move(players)}, timer_{new QTimer(this)} {
+#ifdef Q_OS_LINUX
+    scanner_ = std::make_unique<LinuxProcessScanner>(players_);
+#endif
+    timer_->setSingleShot(true);
+    connect(timer_, &QTimer::timeout, this, &DetectionWorker::poll);
+  }
+
+  void start(const std::chrono::milliseconds interval);
+  void poll();
+  void wake();
+
+private:
+  // What is playing, and where. Recognition only runs when this changes.
+  struct Identity {
+    std::string player;
+    std::uint32_t process_id = 0;
+    std::string media;
+
+    bool operator==(const Identity&) const = default;
+  };
+
+  bool update();
+  void schedule();
+  void publish(std::optional<Detection::player_t> player, std::optional<Detection::media_t> media);
+
+  Detection* detection_ = nullptr;
+  std::vector<Detection::player_t> players_;
+  std::optional<Identity> identity_;
+  std::optional<Episode> episode_;
+
+  QTimer* timer_ = nullptr;
+  std::chrono::milliseconds interval_{0};
+  int backoff_ = 1;
+  int fastPolls_ = 0;
+
+#if defined(Q_OS_WINDOWS)
+  std::unique_ptr<WindowsForegroundHook> foregroundHook_;
+#elif defined(Q_OS_LINUX)
+  std::unique_ptr<LinuxProcessScanner> scanner_;
+  std::unique_ptr<LinuxExecutableWatcher> executableWatcher_;
+#endif
+};
+
+// Called on the worker thread, so that notifications are delivered there
+void DetectionWorker::start(const std::chrono::milliseconds interval) {
+  interval_ = interval;
+
+#if defined(Q_OS_WINDOWS)
+  foregroundHook_ = std::make_unique<WindowsForegroundHook>(players_, [this]() { wake(); });
+#elif defined(Q_OS_LINUX)
+  executableWatcher_ = std::make_unique<LinuxExecutableWatcher>(players_);
+  if (executableWatcher_->fd() > -1) {
+    auto notifier = new QSocketNotifier(executableWatcher_->fd(), QSocketNotifier::Read, this);
+    connect(notifier, &QSocketNotifier::activated, this, [this]() {
+      executableWatcher_->clear();
+      wake();
+    });
+  }
+#endif
+
+  poll();
+}
+
+void DetectionWorker::poll() {
+  if (update()) {
+    fastPolls_ = kFastPollCount;
+    backoff_ = 1;
+  }
+  schedule();
+}
+
+// Notifications only bring the next poll forward, so that a burst of them
+// results in a single poll.
+void DetectionWorker::wake() {
+  fastPolls_ = kFastPollCount;
+  backoff_ = 1;
+  if (!timer_->isActive() || timer_->remainingTime() > kWakeDelay.count()) {
+    timer_->start(kWakeDelay);
+  }
+}
+
+void DetectionWorker::schedule() {
+  if (fastPolls_ > 0) {
+    --fastPolls_;
+    timer_->start(interval_ / kFastPollDivisor);
+  } else if (identity_) {
+    timer_->start(interval_);
+  } else {
+    timer_->start(interval_ * backoff_);
+    backoff_ = std::min(backoff_ * 2, kMaxBackoff);
+  }
+}
+
+// Returns true if what is playing has changed
+bool DetectionWorker::update() {
+#if defined(Q_OS_WINDOWS)
+  const auto result = findMedia(players_);
+#elif defined(Q_OS_LINUX)
+  const auto result = findMedia(players_, *scanner_);
+#else
+  const std::optional<Result> result;
+#endif
+
+  if (!result) {
+    if (!identity_) return false;
+    identity_.reset();
+    episode_.reset();
+    publish(std::nullopt, std::nullopt);
+    return true;
+  }
+
+  const auto& info = result->media.information.front();
+
+  Identity identity{
+      .player = result->player.name,
+      .process_id = result->process_id,
+      .media = info.value,
+  };
+
+  if (identity_ == identity) return false;
+
+  const bool isSameMedia = identity_ && identity_->media == identity.media;
+  identity_ = std::move(identity);
+
+  if (!isSameMedia) {
+    auto episode = [&info]() {
+      if (info.type == anisthesia::MediaInfoType::File) {
+        const QFileInfo fileInfo{QString::fromStdString(info.value)};
+        return recognition::parseFileInfo(fileInfo);
+      } else {
+        return recognition::parse(info.value);
+      }
+    }();
+    episode.setAnimeId(recognition::identify(episode));
+    episode_ = std::move(episode);
+  }
+
+  publish(result->player, result->media);
+  return true;
+}
+
+void DetectionWorker::publish(std::optional<Detection::player_t> player,
+                              std::optional<Detection::media_t> media) {
+  QMetaObject::invokeMethod(
+      detection_,
+      [detection = detection_, player = std::move(player), media = std::move(media),
+       episode = episode_]() { detection->setCurrent(player, media, episode); },
+      Qt::QueuedConnection);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+Detection::Detection(QObject* parent) : QObject(parent), thread_{new QThread(this)} {}
+
+Detection::~Detection() {
+  if (thread_->isRunning()) {
+    thread_->quit();
+    thread_->wait();
+  } else {
+    delete worker_;
+  }
 }
 
 const std::optional<Episode> Detection::getCurrentEpisode() const {
@@ -50,66 +298,48 @@ bool Detection::init() {
     return false;
   }
 
-  if (!anisthesia::ParsePlayersData(file.toStdString(), players_)) {
+  std::vector<player_t> players;
+
+  if (!anisthesia::ParsePlayersData(file.toStdString(), players)) {
     return false;
   }
 
-#ifdef Q_OS_WINDOWS
+  // @TODO: Enable web browser detection
+  std::erase_if(players, [](const player_t& player) {
+    return player.type == anisthesia::PlayerType::WebBrowser;
+  });
+
+  if (players.empty()) return false;
+
+  worker_ = new DetectionWorker(this, std::move(players));
+  worker_->moveToThread(thread_);
+  connect(thread_, &QThread::finished, worker_, &QObject::deleteLater);
+
+#if defined(Q_OS_WINDOWS) || defined(Q_OS_LINUX)
   const auto interval = taiga::settings.mediaDetectionInterval();
-  pollTimer_->start(interval);
+  connect(thread_, &QThread::started, worker_, [worker = worker_, interval]() {
+    worker->start(interval);
+  });
+  thread_->start();
 #endif
 
   return true;
 }
 
 void Detection::poll() {
-#ifdef Q_OS_WINDOWS
-  if (players_.empty()) return;
-
-  // @TODO: Enable web browser detection
-  std::vector<player_t> players;
-  for (const auto player : players_) {
-    if (player.type != anisthesia::PlayerType::WebBrowser) {
-      players.emplace_back(player);
-    }
-  }
+  if (!worker_ || !thread_->isRunning()) return;
+  QMetaObject::invokeMethod(worker_, [worker = worker_]() { worker->poll(); });
+}
 
-  static const auto media_proc = [](const anisthesia::MediaInfo&) {
-    return true;  // Accept all media
-  };
+void Detection::setCurrent(std::optional<player_t> player, std::optional<media_t> media,
+                           std::optional<Episode> episode) {
+  currentPlayer_ = std::move(player);
+  currentMedia_ = std::move(media);
 
-  std::vector<anisthesia::win::Result> results;
-  if (!anisthesia::win::GetResults(players, media_proc, results)) {
-    currentPlayer_.reset();
-    currentMedia_.reset();
-    if (currentEpisode_) {
-      currentEpisode_.reset();
-      emit currentEpisodeChanged(std::nullopt);
-    }
-    return;
-  }
+  if (isSameEpisode(currentEpisode_, episode)) return;
 
-  currentPlayer_ = results.front().player;
-  currentMedia_ = results.front().media.front();
-
-  const auto mediaInfo = currentMedia_->information.front();
-  auto episode = [&mediaInfo]() {
-    if (mediaInfo.type == anisthesia::MediaInfoType::File) {
-      const QFileInfo fileInfo{QString::fromStdString(mediaInfo.value)};
-      return track::recognition::parseFileInfo(fileInfo);
-    } else {
-      return track::recognition::parse(mediaInfo.value);
-    }
-  }();
-
-  const auto animeId = track::recognition::identify(episode);
-  episode.setAnimeId(animeId);
-
-  if (!currentEpisode_ || currentEpisode_->animeId() != animeId) {
-    currentEpisode_ = episode;
-    emit currentEpisodeChanged(episode);
-  }
-#endif
+  currentEpisode_ = std::move(episode);
+  emit currentEpisodeChanged(currentEpisode_);
 }
 
 }  // namespace track::media
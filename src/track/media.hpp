@@ -20,7 +20,7 @@
 
 #include <QApplication>
 #include <QObject>
-#include <QTimer>
+#include <QThread>
 #include <optional>
 #include <vector>
 
@@ -30,33 +30,43 @@
 
 namespace track::media {
 
+class DetectionWorker;
+
+// Players are enumerated on a worker thread. The GUI thread is only involved
+// when what is playing changes.
 class Detection final : public QObject {
   Q_OBJECT
   Q_DISABLE_COPY_MOVE(Detection)
 
 public:
-    using media_t = anisthesia::Media;
-    using player_t = anisthesia::Player;
+  using media_t = anisthesia::Media;
+  using player_t = anisthesia::Player;
 
-	Detection(QObject* parent);
+  Detection(QObject* parent);
+  ~Detection();
 
-	const std::optional<Episode> getCurrentEpisode() const;
-	const std::optional<media_t> getCurrentMedia() const;
-	const std::optional<player_t> getCurrentPlayer() const;
+  const std::optional<Episode> getCurrentEpisode() const;
+  const std::optional<media_t> getCurrentMedia() const;
+  const std::optional<player_t> getCurrentPlayer() const;
 
-	bool init();
-	void poll();
+  bool init();
+  void poll();
 
 signals:
-	void currentEpisodeChanged(std::optional<Episode> media) const;
+  void currentEpisodeChanged(std::optional<Episode> media) const;
 
 private:
-	std::optional<Episode> currentEpisode_;
-	std::optional<media_t> currentMedia_;
-	std::optional<player_t> currentPlayer_;
-	std::vector<player_t> players_;
+  friend class DetectionWorker;
+
+  void setCurrent(std::optional<player_t> player, std::optional<media_t> media,
+                  std::optional<Episode> episode);
+
+  std::optional<Episode> currentEpisode_;
+  std::optional<media_t> currentMedia_;
+  std::optional<player_t> currentPlayer_;
 
-	QTimer* pollTimer_;
+  QThread* thread_ = nullptr;
+  DetectionWorker* worker_ = nullptr;
 };
 
 inline Detection* detection() {
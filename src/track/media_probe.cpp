@@ -0,0 +1,526 @@
+/**
+ * Taiga
+ * Copyright (C) 2010-2025, Eren Okka
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "media_probe.hpp"
+
+#include <QFile>
+#include <algorithm>
+#include <bit>
+
+namespace track {
+
+namespace {
+
+// Headers are expected to be at the beginning of a file. Anything beyond this
+// window is only read when the file tells us exactly where to look.
+constexpr std::uint64_t kHeadSize = 64 * 1024;
+constexpr std::uint64_t kMaxElementSize = 4 * 1024 * 1024;
+constexpr int kMaxTopLevelBoxes = 32;
+
+class Reader final {
+public:
+  explicit Reader(std::span<const std::byte> data) : data_{data} {}
+
+  bool empty() const {
+    return position_ >= data_.size();
+  }
+
+  size_t position() const {
+    return position_;
+  }
+
+  size_t remaining() const {
+    return data_.size() - position_;
+  }
+
+  std::optional<std::span<const std::byte>> read(const std::uint64_t size) {
+    if (size > remaining()) return std::nullopt;
+    const auto data = data_.subspan(position_, size);
+    position_ += size;
+    return data;
+  }
+
+  std::optional<std::uint64_t> readUint(const std::uint64_t size) {
+    if (size > 8) return std::nullopt;
+    const auto data = read(size);
+    if (!data) return std::nullopt;
+    std::uint64_t value = 0;
+    for (const auto byte : *data) {
+      value = (value << 8) | std::to_integer<std::uint8_t>(byte);
+    }
+    return value;
+  }
+
+  bool skip(const std::uint64_t size) {
+    return read(size).has_value();
+  }
+
+private:
+  std::span<const std::byte> data_;
+  size_t position_ = 0;
+};
+
+std::string toString(std::span<const std::byte> data) {
+  std::string str{reinterpret_cast<const char*>(data.data()), data.size()};
+  // Strings may be padded with null characters
+  if (const auto pos = str.find('\0'); pos != std::string::npos) str.resize(pos);
+  return str;
+}
+
+void addLanguage(std::vector<std::string>& languages, std::string language) {
+  if (language.empty() || language == "und") return;
+  if (std::ranges::find(languages, language) != languages.end()) return;
+  languages.push_back(std::move(language));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Matroska
+
+namespace ebml {
+
+// clang-format off
+constexpr std::uint32_t kEbml           = 0x1A45DFA3;
+constexpr std::uint32_t kSegment        = 0x18538067;
+constexpr std::uint32_t kSeekHead       = 0x114D9B74;
+constexpr std::uint32_t kSeek           = 0x4DBB;
+constexpr std::uint32_t kSeekId         = 0x53AB;
+constexpr std::uint32_t kSeekPosition   = 0x53AC;
+constexpr std::uint32_t kInfo           = 0x1549A966;
+constexpr std::uint32_t kTimestampScale = 0x2AD7B1;
+constexpr std::uint32_t kDuration       = 0x4489;
+constexpr std::uint32_t kTitle          = 0x7BA9;
+constexpr std::uint32_t kTracks         = 0x1654AE6B;
+constexpr std::uint32_t kTrackEntry     = 0xAE;
+constexpr std::uint32_t kTrackType      = 0x83;
+constexpr std::uint32_t kLanguage       = 0x22B59C;
+constexpr std::uint32_t kLanguageBcp47  = 0x22B59D;
+constexpr std::uint32_t kCluster        = 0x1F43B675;
+
+constexpr std::uint64_t kTrackTypeAudio    = 2;
+constexpr std::uint64_t kTrackTypeSubtitle = 17;
+// clang-format on
+
+constexpr std::uint64_t kUnknownSize = ~std::uint64_t{0};
+constexpr std::uint64_t kMaxHeaderSize = 12;  // 4-byte ID + 8-byte size
+
+struct Element {
+  std::uint32_t id = 0;
+  std::uint64_t size = 0;
+};
+
+// Variable-length integers encode their length in the leading zero bits of the
+// first byte. IDs keep the length marker, while sizes do not.
+std::optional<Element> readElement(Reader& reader) {
+  const auto readVint = [&reader](const int maxLength, const bool isSize)
+      -> std::optional<std::uint64_t> {
+    const auto first = reader.readUint(1);
+    if (!first || !*first) return std::nullopt;
+    const int length = std::countl_zero(static_cast<std::uint8_t>(*first)) + 1;
+    if (length > maxLength) return std::nullopt;
+    std::uint64_t value = isSize ? *first & (0xFF >> length) : *first;
+    const auto rest = reader.readUint(length - 1);
+    if (!rest) return std::nullopt;
+    value = (value << (8 * (length - 1))) | *rest;
+    if (isSize && value == (std::uint64_t{1} << (7 * length)) - 1) return kUnknownSize;
+    return value;
+  };
+
+  const auto id = readVint(4, false);
+  if (!id) return std::nullopt;
+  const auto size = readVint(8, true);
+  if (!size) return std::nullopt;
+
+  return Element{.id = static_cast<std::uint32_t>(*id), .size = *size};
+}
+
+template <typename Callback>
+void forEachElement(std::span<const std::byte> data, Callback&& callback) {
+  Reader reader{data};
+  while (!reader.empty()) {
+    const auto element = readElement(reader);
+    if (!element || element->size == kUnknownSize) return;
+    const auto body = reader.read(element->size);
+    if (!body) return;
+    callback(element->id, *body);
+  }
+}
+
+double toFloat(std::span<const std::byte> data) {
+  Reader reader{data};
+  const auto value = reader.readUint(data.size());
+  if (!value) return 0.0;
+  switch (data.size()) {
+    case 4:
+      return std::bit_cast<float>(static_cast<std::uint32_t>(*value));
+    case 8:
+      return std::bit_cast<double>(*value);
+    default:
+      return 0.0;
+  }
+}
+
+std::uint64_t toUint(std::span<const std::byte> data) {
+  Reader reader{data};
+  return reader.readUint(data.size()).value_or(0);
+}
+
+void parseInfo(std::span<const std::byte> data, MediaInfo& info) {
+  std::uint64_t scale = 1'000'000;  // nanoseconds per tick
+  double duration = 0.0;
+
+  forEachElement(data, [&](std::uint32_t id, std::span<const std::byte> body) {
+    switch (id) {
+      case kTimestampScale:
+        scale = toUint(body);
+        break;
+      case kDuration:
+        duration = toFloat(body);
+        break;
+      case kTitle:
+        info.title = toString(body);
+        break;
+    }
+  });
+
+  if (duration > 0.0) {
+    info.duration = std::chrono::seconds{static_cast<std::int64_t>(duration * scale / 1e9)};
+  }
+}
+
+void parseTracks(std::span<const std::byte> data, MediaInfo& info) {
+  forEachElement(data, [&info](std::uint32_t id, std::span<const std::byte> body) {
+    if (id != kTrackEntry) return;
+
+    std::uint64_t type = 0;
+    std::string language = "eng";  // default value in the specification
+    std::string bcp47;
+
+    forEachElement(body, [&](std::uint32_t id, std::span<const std::byte> body) {
+      switch (id) {
+        case kTrackType:
+          type = toUint(body);
+          break;
+        case kLanguage:
+          language = toString(body);
+          break;
+        case kLanguageBcp47:
+          bcp47 = toString(body);
+          break;
+      }
+    });
+
+    // BCP 47 takes precedence when both are present
+    if (!bcp47.empty()) language = bcp47;
+
+    if (type == kTrackTypeAudio) {
+      addLanguage(info.audio_languages, std::move(language));
+    } else if (type == kTrackTypeSubtitle) {
+      addLanguage(info.subtitle_languages, std::move(language));
+    }
+  });
+}
+
+void parseSeekHead(std::span<const std::byte> data, std::uint64_t& infoPosition,
+                   std::uint64_t& tracksPosition) {
+  forEachElement(data, [&](std::uint32_t id, std::span<const std::byte> body) {
+    if (id != kSeek) return;
+
+    std::uint64_t seekId = 0;
+    std::uint64_t seekPosition = 0;
+
+    forEachElement(body, [&](std::uint32_t id, std::span<const std::byte> body) {
+      if (id == kSeekId) seekId = toUint(body);
+      if (id == kSeekPosition) seekPosition = toUint(body);
+    });
+
+    if (seekId == kInfo) infoPosition = seekPosition;
+    if (seekId == kTracks) tracksPosition = seekPosition;
+  });
+}
+
+}  // namespace ebml
+
+////////////////////////////////////////////////////////////////////////////////
+// ISO base media file format
+
+namespace bmff {
+
+constexpr std::uint32_t fourcc(const char (&str)[5]) {
+  return (static_cast<std::uint8_t>(str[0]) << 24) | (static_cast<std::uint8_t>(str[1]) << 16) |
+         (static_cast<std::uint8_t>(str[2]) << 8) | static_cast<std::uint8_t>(str[3]);
+}
+
+constexpr std::uint32_t kTitle = 0xA96E616D;  // "©nam"
+
+struct Box {
+  std::uint32_t type = 0;
+  std::uint64_t size = 0;  // excluding the header
+};
+
+std::optional<Box> readBox(Reader& reader) {
+  const auto available = reader.remaining();
+  const auto size = reader.readUint(4);
+  const auto type = reader.readUint(4);
+  if (!size || !type) return std::nullopt;
+
+  std::uint64_t boxSize = *size;
+  std::uint64_t headerSize = 8;
+
+  if (boxSize == 1) {
+    const auto largeSize = reader.readUint(8);
+    if (!largeSize) return std::nullopt;
+    boxSize = *largeSize;
+    headerSize = 16;
+  } else if (boxSize == 0) {
+    boxSize = available;  // box extends to the end of its parent
+  }
+
+  if (boxSize < headerSize) return std::nullopt;
+
+  return Box{.type = static_cast<std::uint32_t>(*type), .size = boxSize - headerSize};
+}
+
+template <typename Callback>
+void forEachBox(std::span<const std::byte> data, Callback&& callback) {
+  Reader reader{data};
+  while (!reader.empty()) {
+    const auto box = readBox(reader);
+    if (!box) return;
+    const auto body = reader.read(std::min<std::uint64_t>(box->size, reader.remaining()));
+    if (!body) return;
+    callback(box->type, *body);
+  }
+}
+
+// Full boxes start with a version byte, followed by 24 bits of flags
+std::optional<std::uint64_t> readVersion(Reader& reader) {
+  const auto version = reader.readUint(1);
+  return version && reader.skip(3) ? version : std::nullopt;
+}
+
+void parseMovieHeader(std::span<const std::byte> data, MediaInfo& info) {
+  Reader reader{data};
+  const auto version = readVersion(reader);
+  if (!version) return;
+
+  const int size = *version == 1 ? 8 : 4;
+  if (!reader.skip(2 * size)) return;  // creation and modification times
+  const auto timescale = reader.readUint(4);
+  const auto duration = reader.readUint(size);
+
+  if (timescale && *timescale && duration) {
+    info.duration = std::chrono::seconds{*duration / *timescale};
+  }
+}
+
+// ISO 639-2/T code packed into three 5-bit characters
+std::string parseMediaLanguage(std::span<const std::byte> data) {
+  Reader reader{data};
+  const auto version = readVersion(reader);
+  if (!version) return {};
+
+  const int size = *version == 1 ? 8 : 4;
+  if (!reader.skip(3 * size + 4)) return {};  // times, timescale and duration
+  const auto packed = reader.readUint(2);
+  if (!packed) return {};
+
+  std::string language(3, '\0');
+  for (int i = 0; i < 3; ++i) {
+    language[i] = static_cast<char>(((*packed >> (10 - 5 * i)) & 0x1F) + 0x60);
+  }
+  return language;
+}
+
+void parseTrack(std::span<const std::byte> data, MediaInfo& info) {
+  std::uint32_t handler = 0;
+  std::string language;
+
+  forEachBox(data, [&](std::uint32_t type, std::span<const std::byte> body) {
+    if (type != fourcc("mdia")) return;
+    forEachBox(body, [&](std::uint32_t type, std::span<const std::byte> body) {
+      if (type == fourcc("mdhd")) {
+        language = parseMediaLanguage(body);
+      } else if (type == fourcc("hdlr")) {
+        Reader reader{body};
+        if (readVersion(reader) && reader.skip(4)) {  // pre-defined
+          handler = static_cast<std::uint32_t>(reader.readUint(4).value_or(0));
+        }
+      }
+    });
+  });
+
+  if (handler == fourcc("soun")) {
+    addLanguage(info.audio_languages, std::move(language));
+  } else if (handler == fourcc("sbtl") || handler == fourcc("subt") ||
+             handler == fourcc("text")) {
+    addLanguage(info.subtitle_languages, std::move(language));
+  }
+}
+
+void parseUserData(std::span<const std::byte> data, MediaInfo& info) {
+  forEachBox(data, [&info](std::uint32_t type, std::span<const std::byte> body) {
+    if (type != fourcc("meta")) return;
+
+    // In MP4 files "meta" is a full box, while QuickTime omits version and flags
+    Reader reader{body};
+    if (reader.skip(4) && reader.readUint(4) != fourcc("hdlr")) body = body.subspan(4);
+
+    forEachBox(body, [&info](std::uint32_t type, std::span<const std::byte> body) {
+      if (type != fourcc("ilst")) return;
+      forEachBox(body, [&info](std::uint32_t type, std::span<const std::byte> body) {
+        if (type != kTitle) return;
+        forEachBox(body, [&info](std::uint32_t type, std::span<const std::byte> body) {
+          // Type indicator and locale precede the value
+          if (type == fourcc("data") && body.size() > 8) info.title = toString(body.subspan(8));
+        });
+      });
+    });
+  });
+}
+
+void parseMovie(std::span<const std::byte> data, MediaInfo& info) {
+  forEachBox(data, [&info](std::uint32_t type, std::span<const std::byte> body) {
+    if (type == fourcc("mvhd")) {
+      parseMovieHeader(body, info);
+    } else if (type == fourcc("trak")) {
+      parseTrack(body, info);
+    } else if (type == fourcc("udta")) {
+      parseUserData(body, info);
+    }
+  });
+}
+
+}  // namespace bmff
+
+}  // namespace
+
+std::optional<MediaInfo> probeMatroska(const map_callback_t& map) {
+  using namespace ebml;
+
+  const auto head = map(0, kHeadSize);
+  Reader reader{head};
+
+  const auto header = readElement(reader);
+  if (!header || header->id != kEbml || !reader.skip(header->size)) return std::nullopt;
+
+  const auto segment = readElement(reader);
+  if (!segment || segment->id != kSegment) return std::nullopt;
+
+  // Seek positions are relative to the beginning of the segment's data
+  const std::uint64_t segmentOffset = reader.position();
+
+  MediaInfo info;
+  bool hasInfo = false;
+  bool hasTracks = false;
+  std::uint64_t infoPosition = 0;
+  std::uint64_t tracksPosition = 0;
+
+  const auto parseElement = [&](const Element& element, const std::uint64_t offset) {
+    if (element.size > kMaxElementSize) return;
+
+    auto body = offset + element.size <= head.size() ? head.subspan(offset, element.size)
+                                                     : map(offset, element.size);
+    if (body.size() < element.size) return;
+
+    switch (element.id) {
+      case kSeekHead:
+        parseSeekHead(body, infoPosition, tracksPosition);
+        break;
+      case kInfo:
+        parseInfo(body, info);
+        hasInfo = true;
+        break;
+      case kTracks:
+        parseTracks(body, info);
+        hasTracks = true;
+        break;
+    }
+  };
+
+  // Top-level elements are read until the first cluster, where media data
+  // begins, or until the end of the head window.
+  while (!reader.empty()) {
+    const auto element = readElement(reader);
+    if (!element || element->id == kCluster || element->size == kUnknownSize) break;
+    parseElement(*element, reader.position());
+    if (!reader.skip(element->size)) break;
+  }
+
+  const auto parseAt = [&](const std::uint64_t position) {
+    const auto offset = segmentOffset + position;
+    Reader reader{map(offset, kMaxHeaderSize)};
+    const auto element = readElement(reader);
+    if (element) parseElement(*element, offset + reader.position());
+  };
+
+  if (!hasInfo && infoPosition) parseAt(infoPosition);
+  if (!hasTracks && tracksPosition) parseAt(tracksPosition);
+
+  return info;
+}
+
+std::optional<MediaInfo> probeMp4(const map_callback_t& map) {
+  using namespace bmff;
+
+  std::uint64_t offset = 0;
+
+  // Only box headers are read until we find the movie box, which may come after
+  // media data in files that were not optimized for streaming.
+  for (int i = 0; i < kMaxTopLevelBoxes; ++i) {
+    Reader reader{map(offset, 16)};
+    const auto box = readBox(reader);
+    if (!box) break;
+    if (i == 0 && box->type != fourcc("ftyp")) break;
+
+    if (box->type == fourcc("moov")) {
+      if (box->size > kMaxElementSize) break;
+      const auto body = map(offset + reader.position(), box->size);
+      MediaInfo info;
+      parseMovie(body, info);
+      return info;
+    }
+
+    offset += reader.position() + box->size;
+  }
+
+  return std::nullopt;
+}
+
+std::optional<MediaInfo> probeMediaFile(const QString& path) {
+  QFile file{path};
+  if (!file.open(QFile::ReadOnly)) return std::nullopt;
+
+  const auto fileSize = static_cast<std::uint64_t>(file.size());
+
+  // Mapped regions stay valid until the file is closed
+  const map_callback_t map = [&file, fileSize](std::uint64_t offset,
+                                               std::uint64_t size) -> std::span<const std::byte> {
+    if (offset >= fileSize) return {};
+    size = std::min(size, fileSize - offset);
+    const auto data = file.map(static_cast<qint64>(offset), static_cast<qint64>(size));
+    if (!data) return {};
+    return {reinterpret_cast<const std::byte*>(data), static_cast<size_t>(size)};
+  };
+
+  if (auto info = probeMatroska(map)) return info;
+  if (auto info = probeMp4(map)) return info;
+
+  return std::nullopt;
+}
+
+}  // namespace track
@@ -0,0 +1,51 @@
+/**
+ * Taiga
+ * Copyright (C) 2010-2025, Eren Okka
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QString>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace track {
+
+// Container-level metadata that is available without decoding any streams
+struct MediaInfo {
+  std::string title;
+  std::chrono::seconds duration{0};
+  std::vector<std::string> audio_languages;
+  std::vector<std::string> subtitle_languages;
+};
+
+// Returns a read-only view of the requested range, which may be shorter than
+// `size` at the end of the file. Probes never request more than they parse.
+using map_callback_t =
+    std::function<std::span<const std::byte>(std::uint64_t offset, std::uint64_t size)>;
+
+std::optional<MediaInfo> probeMatroska(const map_callback_t& map);
+std::optional<MediaInfo> probeMp4(const map_callback_t& map);
+
+std::optional<MediaInfo> probeMediaFile(const QString& path);
+
+}  // namespace track
@@ -0,0 +1,428 @@
+/**
+ * Taiga
+ * Copyright (C) 2010-2025, Eren Okka
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "linux.hpp"
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <charconv>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <format>
+#include <memory>
+#include <ranges>
+#include <set>
+#include <vector>
+
+namespace {
+
+constexpr size_t kDirentBufferSize = 256 * 1024;
+
+// clang-format off
+constexpr std::array<std::string_view, 14> kVideoExtensions{
+    "avi", "flv", "m2ts", "m4v", "mkv", "mov", "mp4",
+    "mpeg", "mpg", "ogm", "rmvb", "ts", "webm", "wmv",
+};
+// clang-format on
+
+// Hands out null-terminated paths from large blocks, so that directories that
+// are waiting to be visited do not cost an allocation each.
+class PathArena final {
+public:
+  std::string_view store(std::string_view directory, std::string_view name) {
+    const bool needs_separator = !name.empty() && !directory.ends_with('/');
+    const size_t length = directory.size() + needs_separator + name.size();
+
+    char* data = allocate(length + 1);
+    std::memcpy(data, directory.data(), directory.size());
+    if (needs_separator) data[directory.size()] = '/';
+    std::memcpy(data + directory.size() + needs_separator, name.data(), name.size());
+    data[length] = '\0';
+
+    return {data, length};
+  }
+
+private:
+  static constexpr size_t kBlockSize = 64 * 1024;
+
+  char* allocate(const size_t size) {
+    if (size > kBlockSize) {
+      return blocks_.emplace_back(std::make_unique_for_overwrite<char[]>(size)).get();
+    }
+    if (used_ + size > kBlockSize) {
+      current_ = blocks_.emplace_back(std::make_unique_for_overwrite<char[]>(kBlockSize)).get();
+      used_ = 0;
+    }
+    char* data = current_ + used_;
+    used_ += size;
+    return data;
+  }
+
+  std::vector<std::unique_ptr<char[]>> blocks_;
+  char* current_ = nullptr;
+  size_t used_ = kBlockSize;
+};
+
+class FileDescriptor final {
+public:
+  explicit FileDescriptor(const int fd) : fd_{fd} {}
+  ~FileDescriptor() {
+    if (fd_ > -1) ::close(fd_);
+  }
+
+  FileDescriptor(const FileDescriptor&) = delete;
+  FileDescriptor& operator=(const FileDescriptor&) = delete;
+
+  int get() const {
+    return fd_;
+  }
+
+private:
+  int fd_ = -1;
+};
+
+class Directory final {
+public:
+  explicit Directory(DIR* dir) : dir_{dir} {}
+  ~Directory() {
+    if (dir_) ::closedir(dir_);
+  }
+
+  Directory(const Directory&) = delete;
+  Directory& operator=(const Directory&) = delete;
+
+  DIR* get() const {
+    return dir_;
+  }
+
+private:
+  DIR* dir_ = nullptr;
+};
+
+std::string toLower(std::string_view str) {
+  return str | std::views::transform([](unsigned char c) { return std::tolower(c); }) |
+         std::ranges::to<std::string>();
+}
+
+std::optional<std::uint32_t> toPid(std::string_view name) {
+  std::uint32_t pid = 0;
+  const auto [ptr, ec] = std::from_chars(name.data(), name.data() + name.size(), pid);
+  if (ec != std::errc{} || ptr != name.data() + name.size()) return std::nullopt;
+  return pid;
+}
+
+std::optional<std::string> readLink(const int dirfd, const std::string& path) {
+  std::array<char, 4096> buffer;
+  const auto size = ::readlinkat(dirfd, path.c_str(), buffer.data(), buffer.size());
+  if (size < 0 || static_cast<size_t>(size) == buffer.size()) return std::nullopt;
+  return std::string{buffer.data(), static_cast<size_t>(size)};
+}
+
+std::optional<std::string> readSmallFile(const int dirfd, const std::string& path) {
+  const FileDescriptor fd{::openat(dirfd, path.c_str(), O_RDONLY | O_CLOEXEC)};
+  if (fd.get() < 0) return std::nullopt;
+  std::array<char, 1024> buffer;
+  const auto size = ::read(fd.get(), buffer.data(), buffer.size());
+  if (size < 0) return std::nullopt;
+  return std::string{buffer.data(), static_cast<size_t>(size)};
+}
+
+struct ProcessStat {
+  std::string command;
+  std::uint64_t start_time = 0;
+};
+
+// The start time is the 22nd field of `/proc/<pid>/stat`. The second field is
+// the command name in parentheses, which may contain spaces and parentheses.
+std::optional<ProcessStat> readProcessStat(const int dirfd, const std::string& pid) {
+  const auto stat = readSmallFile(dirfd, pid + "/stat");
+  if (!stat) return std::nullopt;
+
+  const auto begin = stat->find('(');
+  const auto pos = stat->rfind(')');
+  if (begin == std::string::npos || pos == std::string::npos || pos < begin) return std::nullopt;
+
+  ProcessStat result{.command = stat->substr(begin + 1, pos - begin - 1)};
+
+  std::string_view fields{std::string_view{*stat}.substr(pos + 1)};
+  for (int field = 3; field <= 22; ++field) {
+    fields.remove_prefix(std::min(fields.find_first_not_of(' '), fields.size()));
+    const auto end = std::min(fields.find(' '), fields.size());
+    if (field == 22) {
+      const auto [_, ec] = std::from_chars(fields.data(), fields.data() + end, result.start_time);
+      if (ec != std::errc{}) return std::nullopt;
+      return result;
+    }
+    fields.remove_prefix(end);
+  }
+
+  return std::nullopt;
+}
+
+// `statx` follows symbolic links, so they have to be asked about separately
+bool isSymlink(const int dirfd, const char* name) {
+  struct statx stx{};
+  return ::statx(dirfd, name, AT_SYMLINK_NOFOLLOW | AT_STATX_DONT_SYNC, STATX_TYPE, &stx) == 0 &&
+         S_ISLNK(stx.stx_mode);
+}
+
+bool isVideoFile(std::string_view path) {
+  if (!path.starts_with('/')) return false;  // pipes, sockets, etc.
+  const auto pos = path.find_last_of("./");
+  if (pos == std::string_view::npos || path[pos] != '.') return false;
+  const auto extension = toLower(path.substr(pos + 1));
+  return std::ranges::find(kVideoExtensions, extension) != kVideoExtensions.end();
+}
+
+}  // namespace
+
+namespace track {
+
+bool LinuxFileWalker::walk(std::string_view root, const WalkOptions& options,
+                           const walk_callback_t& callback) {
+  while (root.size() > 1 && root.ends_with('/')) root.remove_suffix(1);
+
+  if (root.empty()) return false;
+
+  PathArena arena;
+  std::vector<std::string_view> pending{arena.store(root, {})};
+
+  const auto buffer = std::make_unique_for_overwrite<std::byte[]>(kDirentBufferSize);
+
+  const unsigned int stat_mask = STATX_TYPE | (options.stat ? STATX_SIZE | STATX_MTIME : 0);
+
+  for (bool is_root = true; !pending.empty(); is_root = false) {
+    const auto directory = pending.back();
+    pending.pop_back();
+
+    const FileDescriptor fd{::open(directory.data(), O_RDONLY | O_DIRECTORY | O_CLOEXEC)};
+    if (fd.get() < 0) {
+      if (is_root) return false;
+      continue;
+    }
+
+    while (true) {
+      const auto bytes = ::syscall(SYS_getdents64, fd.get(), buffer.get(), kDirentBufferSize);
+      if (bytes <= 0) break;
+
+      for (long offset = 0; offset < bytes;) {
+        const auto dirent = reinterpret_cast<const dirent64*>(buffer.get() + offset);
+        offset += dirent->d_reclen;
+
+        const std::string_view name{dirent->d_name};
+        if (name.starts_with('.')) continue;  // hidden entries, including "." and ".."
+
+        FileEntry entry{
+            .directory = directory,
+            .name = name,
+            .is_symlink = dirent->d_type == DT_LNK,
+        };
+
+        auto type = dirent->d_type;
+
+        // Some file systems do not fill in `d_type`, and symbolic links need to
+        // be resolved, so we only ask for what we are missing.
+        if (options.stat || type == DT_UNKNOWN || entry.is_symlink) {
+          if (options.before_stat) options.before_stat();
+          struct statx stx{};
+          if (::statx(fd.get(), dirent->d_name, AT_STATX_DONT_SYNC, stat_mask, &stx) != 0) {
+            continue;
+          }
+          if (type == DT_UNKNOWN) {
+            if (options.before_stat) options.before_stat();
+            entry.is_symlink = isSymlink(fd.get(), dirent->d_name);
+          }
+          type = S_ISDIR(stx.stx_mode) ? DT_DIR : S_ISREG(stx.stx_mode) ? DT_REG : DT_UNKNOWN;
+          entry.size = stx.stx_size;
+          entry.last_modified = stx.stx_mtime.tv_sec;
+        }
+
+        if (type != DT_DIR && type != DT_REG) continue;
+
+        entry.is_directory = type == DT_DIR;
+
+        switch (callback(entry)) {
+          case WalkResult::Continue:
+            break;
+          case WalkResult::SkipDirectory:
+            continue;
+          case WalkResult::Stop:
+            return true;
+        }
+
+        // Symbolic links to directories are not followed, same as `QDirIterator`
+        if (entry.is_directory && options.recursive && !entry.is_symlink) {
+          pending.push_back(arena.store(directory, name));
+        }
+      }
+    }
+  }
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+LinuxProcessScanner::LinuxProcessScanner(const std::vector<anisthesia::Player>& players,
+                                         std::string procRoot)
+    : proc_root_{std::move(procRoot)} {
+  for (const auto& player : players) {
+    executables_.push_back(player.executables | std::views::transform(toLower) |
+                           std::ranges::to<std::vector>());
+  }
+}
+
+std::vector<LinuxProcessScanner::Result> LinuxProcessScanner::scan() {
+  std::vector<Result> results;
+
+  const Directory dir{::opendir(proc_root_.c_str())};
+  if (!dir.get()) return results;
+
+  const int dirfd = ::dirfd(dir.get());
+  ++generation_;
+
+  while (const auto entry = ::readdir(dir.get())) {
+    const auto pid = toPid(entry->d_name);
+    if (!pid) continue;
+
+    const std::string name{entry->d_name};
+    auto stat = readProcessStat(dirfd, name);
+    if (!stat) continue;  // the process has exited
+
+    auto& process = processes_[*pid];
+    process.generation = generation_;
+
+    // The executable link is not readable for processes of other users
+    auto executable = readLink(dirfd, name + "/exe").value_or(std::string{});
+
+    // A different start time means the PID was reused by another process. A
+    // different executable or command name means that the process has called
+    // `exec`, e.g. a launcher script that replaced itself with the player.
+    if (process.start_time != stat->start_time || process.executable != executable ||
+        process.command != stat->command) {
+      process.start_time = stat->start_time;
+      process.executable = std::move(executable);
+      process.command = std::move(stat->command);
+      process.player = findPlayer(dirfd, name);
+    }
+
+    if (!process.player) continue;
+
+    if (auto path = findOpenVideo(dirfd, name); !path.empty()) {
+      results.emplace_back(*process.player, *pid, std::move(path));
+    }
+  }
+
+  std::erase_if(processes_,
+                [this](const auto& pair) { return pair.second.generation != generation_; });
+
+  return results;
+}
+
+std::optional<size_t> LinuxProcessScanner::findPlayer(const int dirfd,
+                                                      const std::string& pid) const {
+  // The executable link is not readable for processes of other users, while
+  // the command name is limited to 15 characters.
+  auto executable = readLink(dirfd, pid + "/exe");
+  if (executable) {
+    if (const auto pos = executable->rfind('/'); pos != std::string::npos) {
+      executable->erase(0, pos + 1);
+    }
+  } else {
+    executable = readSmallFile(dirfd, pid + "/comm");
+    if (!executable) return std::nullopt;
+    while (executable->ends_with('\n')) executable->pop_back();
+  }
+
+  const auto name = toLower(*executable);
+
+  for (size_t i = 0; i < executables_.size(); ++i) {
+    if (std::ranges::find(executables_[i], name) != executables_[i].end()) return i;
+  }
+
+  return std::nullopt;
+}
+
+std::string LinuxProcessScanner::findOpenVideo(const int dirfd, const std::string& pid) const {
+  const int fd = ::openat(dirfd, (pid + "/fd").c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+  if (fd < 0) return {};
+
+  const Directory dir{::fdopendir(fd)};
+  if (!dir.get()) {
+    ::close(fd);
+    return {};
+  }
+
+  while (const auto entry = ::readdir(dir.get())) {
+    if (entry->d_name[0] == '.') continue;
+    const auto path = readLink(fd, entry->d_name);
+    if (path && isVideoFile(*path)) return *path;
+  }
+
+  return {};
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+LinuxExecutableWatcher::LinuxExecutableWatcher(const std::vector<anisthesia::Player>& players)
+    : fd_{::inotify_init1(IN_NONBLOCK | IN_CLOEXEC)} {
+  if (fd_ < 0) return;
+
+  const char* path = std::getenv("PATH");
+  if (!path) return;
+
+  std::set<std::string> names;
+  for (const auto& player : players) {
+    names.insert(player.executables.begin(), player.executables.end());
+  }
+
+  for (const auto directory : std::string_view{path} | std::views::split(':')) {
+    if (directory.empty()) continue;
+    for (const auto& name : names) {
+      const auto file = std::format("{}/{}", std::string_view{directory}, name);
+      if (::access(file.c_str(), X_OK) == 0) {
+        ::inotify_add_watch(fd_, file.c_str(), IN_OPEN);
+      }
+    }
+  }
+}
+
+LinuxExecutableWatcher::~LinuxExecutableWatcher() {
+  if (fd_ > -1) ::close(fd_);
+}
+
+int LinuxExecutableWatcher::fd() const {
+  return fd_;
+}
+
+void LinuxExecutableWatcher::clear() const {
+  std::array<char, 4096> buffer;
+  while (::read(fd_, buffer.data(), buffer.size()) > 0) {
+  }
+}
+
+}  // namespace track
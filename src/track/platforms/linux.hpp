@@ -0,0 +1,94 @@
+/**
+ * Taiga
+ * Copyright (C) 2010-2025, Eren Okka
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <anisthesia.hpp>
+
+#include "track/file_walker.hpp"
+
+namespace track {
+
+// Reads directory entries in large batches with `getdents64`, and relies on
+// `d_type` to avoid calling `statx` for each entry unless sizes and times are
+// requested.
+class LinuxFileWalker final : public FileWalker {
+public:
+  bool walk(std::string_view root, const WalkOptions& options,
+            const walk_callback_t& callback) override;
+};
+
+// Finds running media players by their executable names, and the video files
+// they have open through `/proc/<pid>/fd`. Processes are cached by PID, and are
+// only examined again when their start time, executable or command name
+// changes.
+class LinuxProcessScanner final {
+public:
+  struct Result {
+    size_t player = 0;  // index into the list of players
+    std::uint32_t pid = 0;
+    std::string path;
+  };
+
+  explicit LinuxProcessScanner(const std::vector<anisthesia::Player>& players,
+                               std::string procRoot = "/proc");
+
+  std::vector<Result> scan();
+
+private:
+  struct Process {
+    std::uint64_t start_time = 0;
+    std::string executable;
+    std::string command;
+    std::optional<size_t> player;
+    unsigned int generation = 0;
+  };
+
+  std::optional<size_t> findPlayer(const int dirfd, const std::string& pid) const;
+  std::string findOpenVideo(const int dirfd, const std::string& pid) const;
+
+  std::vector<std::vector<std::string>> executables_;
+  std::string proc_root_;
+  std::unordered_map<std::uint32_t, Process> processes_;
+  unsigned int generation_ = 0;
+};
+
+// Watches player executables in `PATH` with inotify. Executing a file opens
+// it, so the descriptor becomes readable shortly after a player is started.
+class LinuxExecutableWatcher final {
+public:
+  explicit LinuxExecutableWatcher(const std::vector<anisthesia::Player>& players);
+  ~LinuxExecutableWatcher();
+
+  LinuxExecutableWatcher(const LinuxExecutableWatcher&) = delete;
+  LinuxExecutableWatcher& operator=(const LinuxExecutableWatcher&) = delete;
+
+  int fd() const;
+  void clear() const;
+
+private:
+  int fd_ = -1;
+};
+
+}  // namespace track
@@ -0,0 +1,115 @@
+/**
+ * Taiga
+ * Copyright (C) 2010-2025, Eren Okka
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "windows.hpp"
+
+#include <algorithm>
+#include <cwctype>
+#include <ranges>
+#include <string>
+#include <string_view>
+
+#include <windows.h>
+
+namespace {
+
+// Out-of-context hooks are called on the thread that installed them
+thread_local track::WindowsForegroundHook::callback_t foregroundCallback;
+thread_local std::vector<std::wstring> playerExecutables;
+
+std::wstring toLower(std::wstring_view str) {
+  return str | std::views::transform([](wchar_t c) { return std::towlower(c); }) |
+         std::ranges::to<std::wstring>();
+}
+
+std::wstring toWide(std::string_view str) {
+  const auto length = static_cast<int>(str.size());
+  std::wstring result(::MultiByteToWideChar(CP_UTF8, 0, str.data(), length, nullptr, 0), 0);
+  ::MultiByteToWideChar(CP_UTF8, 0, str.data(), length, result.data(),
+                        static_cast<int>(result.size()));
+  return result;
+}
+
+// Returns the lowercase file name of the executable that owns the window, or an
+// empty string if the process cannot be queried.
+std::wstring windowExecutable(HWND hwnd) {
+  DWORD pid = 0;
+  if (!hwnd || !::GetWindowThreadProcessId(hwnd, &pid) || !pid) return {};
+
+  const auto process = ::OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, pid);
+  if (!process) return {};
+
+  std::wstring path(MAX_PATH, 0);
+  auto size = static_cast<DWORD>(path.size());
+  const bool succeeded = ::QueryFullProcessImageNameW(process, 0, path.data(), &size);
+  ::CloseHandle(process);
+  if (!succeeded) return {};
+  path.resize(size);
+
+  if (const auto pos = path.find_last_of(L"\\/"); pos != std::wstring::npos) {
+    path.erase(0, pos + 1);
+  }
+
+  return toLower(path);
+}
+
+bool isPlayerExecutable(const std::wstring& executable) {
+  if (executable.empty()) return false;
+
+  // Executables may be listed with or without their extension
+  const auto stem = executable.ends_with(L".exe")
+                        ? std::wstring_view{executable}.substr(0, executable.size() - 4)
+                        : std::wstring_view{executable};
+
+  return std::ranges::any_of(playerExecutables, [&](const std::wstring& name) {
+    return name == executable || name == stem;
+  });
+}
+
+void CALLBACK onForegroundChanged(HWINEVENTHOOK, DWORD, HWND hwnd, LONG, LONG, DWORD, DWORD) {
+  if (!foregroundCallback) return;
+  if (!isPlayerExecutable(windowExecutable(hwnd))) return;
+  foregroundCallback();
+}
+
+}  // namespace
+
+namespace track {
+
+WindowsForegroundHook::WindowsForegroundHook(const std::vector<anisthesia::Player>& players,
+                                             callback_t callback) {
+  playerExecutables.clear();
+  for (const auto& player : players) {
+    for (const auto& executable : player.executables) {
+      playerExecutables.push_back(toLower(toWide(executable)));
+    }
+  }
+
+  foregroundCallback = std::move(callback);
+  hook_ = ::SetWinEventHook(EVENT_SYSTEM_FOREGROUND, EVENT_SYSTEM_FOREGROUND, nullptr,
+                            onForegroundChanged, 0, 0,
+                            WINEVENT_OUTOFCONTEXT | WINEVENT_SKIPOWNPROCESS);
+}
+
+WindowsForegroundHook::~WindowsForegroundHook() {
+  if (hook_) ::UnhookWinEvent(static_cast<HWINEVENTHOOK>(hook_));
+  foregroundCallback = nullptr;
+  playerExecutables.clear();
+}
+
+}  // namespace track
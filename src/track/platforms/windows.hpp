@@ -0,0 +1,46 @@
+/**
+ * Taiga
+ * Copyright (C) 2010-2025, Eren Okka
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <functional>
+#include <vector>
+
+#include <anisthesia.hpp>
+
+namespace track {
+
+// Calls back whenever a window of a media player comes to the foreground, which
+// is what happens when a player is started. Windows of other applications are
+// ignored. The hook belongs to the thread that creates it, and is only serviced
+// while that thread runs an event loop.
+class WindowsForegroundHook final {
+public:
+  using callback_t = std::function<void()>;
+
+  WindowsForegroundHook(const std::vector<anisthesia::Player>& players, callback_t callback);
+  ~WindowsForegroundHook();
+
+  WindowsForegroundHook(const WindowsForegroundHook&) = delete;
+  WindowsForegroundHook& operator=(const WindowsForegroundHook&) = delete;
+
+private:
+  void* hook_ = nullptr;
+};
+
+}  // namespace track
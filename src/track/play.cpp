@@ -19,15 +19,24 @@
 #include "play.hpp"
 
 #include <QDesktopServices>
+#include <QFile>
 #include <QUrl>
 
 #include "media/anime_db.hpp"
 #include "taiga/settings.hpp"
+#include "track/library.hpp"
 #include "track/scanner.hpp"
 
 namespace track {
 
 bool playEpisode(int animeId, int number) {
+  if (const auto episodePath = library.episodePath(animeId, number)) {
+    if (QFile::exists(*episodePath)) {
+      qDebug() << "Found file in library:" << *episodePath;
+      return QDesktopServices::openUrl(QUrl::fromLocalFile(*episodePath));
+    }
+  }
+
   const auto libraryFolders = taiga::settings.libraryFolders();
 
   for (const auto& folder : libraryFolders) {
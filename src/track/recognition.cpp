@@ -26,7 +26,6 @@
 #include <vector>
 
 #include "media/anime.hpp"
-#include "media/anime_db.hpp"
 #include "track/episode.hpp"
 #include "track/recognition_cache.hpp"
 #include "track/recognition_normalize.hpp"
@@ -42,42 +41,49 @@ Episode parse(std::string_view input, const anitomy::Options options) {
   return episode;
 }
 
-Episode parseFileInfo(const QFileInfo& info, const anitomy::Options options) {
-  const auto fileName = info.fileName().toStdString();
-
+Episode parseFile(std::string_view fileName, std::string_view dirName,
+                  const anitomy::Options options) {
   Episode episode = track::recognition::parse(fileName, options);
 
   if (!episode.contains(anitomy::ElementKind::Title)) {
-    const auto dirName = info.dir().dirName().toStdString();
-    episode.addElement(anitomy::ElementKind::Title, dirName);
+    episode.addElement(anitomy::ElementKind::Title, std::string{dirName});
   }
 
   return episode;
 }
 
+Episode parseFileInfo(const QFileInfo& info, const anitomy::Options options) {
+  const auto fileName = info.fileName().toStdString();
+  const auto dirName = info.dir().dirName().toStdString();
+
+  return parseFile(fileName, dirName, options);
+}
+
 int identify(Episode& episode) {
-  cache()->init();
+  return identify(*cache(), episode);
+}
 
+int identify(const Cache& cache, Episode& episode) {
   const auto title = episode.element(anitomy::ElementKind::Title);
   const auto normalizedTitle = normalize(title);
 
   std::vector<Cache::Data::Match> matches;
 
-  if (const auto data = cache()->find(normalizedTitle)) {
+  if (const auto data = cache.find(normalizedTitle)) {
     matches.append_range(data->matches | std::views::values | std::ranges::to<std::vector>());
   }
 
   std::ranges::sort(matches, std::ranges::greater{}, &Cache::Data::Match::weight);
 
   for (const auto& match : matches) {
-    if (isValidMatch(match.id, episode)) return match.id;
+    if (isValidMatch(cache, match.id, episode)) return match.id;
   }
 
   return anime::kUnknownId;
 }
 
-bool isValidMatch(const int id, const Episode& episode) {
-  const auto item = anime::db.item(id);
+bool isValidMatch(const Cache& cache, const int id, const Episode& episode) {
+  const auto item = cache.item(id);
 
   if (!item) return false;
 
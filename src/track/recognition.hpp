@@ -29,10 +29,15 @@ class Episode;
 namespace track::recognition {
 
 Episode parse(std::string_view input, const anitomy::Options options = {});
+Episode parseFile(std::string_view fileName, std::string_view dirName,
+                  const anitomy::Options options = {});
 Episode parseFileInfo(const QFileInfo& info, const anitomy::Options options = {});
 
+class Cache;
+
 int identify(Episode& episode);
+int identify(const Cache& cache, Episode& episode);
 
-bool isValidMatch(const int id, const Episode& episode);
+bool isValidMatch(const Cache& cache, const int id, const Episode& episode);
 
 }  // namespace track::recognition
@@ -18,14 +18,36 @@
 
 #include "recognition_cache.hpp"
 
+#include <QTimer>
 #include <format>
+#include <mutex>
 
 #include "media/anime_db.hpp"
+#include "media/anime_utils.hpp"
 #include "track/recognition.hpp"
 #include "track/recognition_normalize.hpp"
 
 namespace track::recognition {
 
+namespace {
+
+std::mutex mutex;
+std::shared_ptr<const Cache> snapshot;
+
+void rebuild() {
+  auto cache = std::make_shared<const Cache>(anime::db.items());
+  const std::lock_guard lock{mutex};
+  snapshot = std::move(cache);
+}
+
+}  // namespace
+
+Cache::Cache(const QMap<int, anime::Details>& items) {
+  for (const auto& item : items) {
+    add(item);
+  }
+}
+
 bool Cache::empty() const {
   return titles_.empty();
 }
@@ -36,19 +58,22 @@ const std::optional<Cache::Data> Cache::find(const std::string& title) const {
   return it->second;
 }
 
-void Cache::clear() {
-  return titles_.clear();
+bool Cache::contains(const std::string& title, const int id) const {
+  const auto it = titles_.find(title);
+  return it != titles_.end() && it->second.matches.contains(id);
 }
 
-void Cache::init() {
-  if (!empty()) return;
-
-  for (const auto& item : anime::db.items()) {
-    add(item);
-  }
+const Cache::Item* Cache::item(const int id) const {
+  const auto it = items_.find(id);
+  return it != items_.end() ? &it->second : nullptr;
 }
 
 void Cache::add(const anime::Details& item) {
+  items_[item.id] = {
+      .episode_count = item.episode_count,
+      .episode_length = anime::estimateEpisodeLength(item),
+  };
+
   const auto add = [this, &item](const std::string& title, const float weight = 1.0f) {
     const auto normalized = normalize(title);
     if (normalized.empty()) return;
@@ -85,15 +110,23 @@ void Cache::add(const anime::Details& item) {
   }
 }
 
-void Cache::remove(const anime::Details& item) {
-  for (auto& [_, data] : titles_) {
-    data.matches.erase(item.id);
-  }
+std::shared_ptr<const Cache> cache() {
+  static const auto empty = std::make_shared<const Cache>();
+  const std::lock_guard lock{mutex};
+  return snapshot ? snapshot : empty;
 }
 
-void Cache::update(const anime::Details& item) {
-  remove(item);
-  add(item);
+void initCache() {
+  rebuild();
+
+  // Changes come in bursts (e.g. a page of items), so they are applied at once
+  const auto timer = new QTimer(&anime::db);
+  timer->setSingleShot(true);
+  timer->setInterval(0);
+  QObject::connect(timer, &QTimer::timeout, timer, &rebuild);
+
+  QObject::connect(&anime::db, &anime::Database::listUpdated, timer, [timer]() { timer->start(); });
+  QObject::connect(&anime::db, &anime::Database::itemUpdated, timer, [timer]() { timer->start(); });
 }
 
 }  // namespace track::recognition
@@ -18,6 +18,8 @@
 
 #pragma once
 
+#include <QMap>
+#include <memory>
 #include <optional>
 #include <set>
 #include <string>
@@ -29,6 +31,8 @@ struct Details;
 
 namespace track::recognition {
 
+// An immutable snapshot of what recognition needs from the anime database, so
+// that it can be used from worker threads while the database changes.
 class Cache final {
 public:
   struct Data {
@@ -40,23 +44,31 @@ public:
     std::unordered_map<int, Match> matches;
   };
 
+  struct Item {
+    int episode_count = 0;
+    int episode_length = 0;  // estimated, if unknown
+  };
+
+  Cache() = default;
+  explicit Cache(const QMap<int, anime::Details>& items);
+
   bool empty() const;
   const std::optional<Data> find(const std::string& title) const;
+  bool contains(const std::string& title, const int id) const;
+  const Item* item(const int id) const;
 
-  void clear();
-  void init();
-
+private:
   void add(const anime::Details& item);
-  void remove(const anime::Details& item);
-  void update(const anime::Details& item);
 
-private:
   std::unordered_map<std::string, Data> titles_;
+  std::unordered_map<int, Item> items_;
 };
 
-inline Cache* cache() {
-  static Cache cache;
-  return &cache;
-}
+// Returns the latest snapshot. It can be called from any thread.
+std::shared_ptr<const Cache> cache();
+
+// Builds a snapshot, and a new one on the GUI thread whenever the database
+// changes.
+void initCache();
 
 }  // namespace track::recognition
@@ -18,54 +18,141 @@
 
 #include "scanner.hpp"
 
-#include <QDirIterator>
+#include <format>
 #include <optional>
 
+#include "media/anime.hpp"
 #include "track/episode.hpp"
+#include "track/file_walker.hpp"
 #include "track/recognition.hpp"
+#include "track/recognition_cache.hpp"
+#include "track/recognition_normalize.hpp"
 
 namespace track {
 
-std::optional<QString> findEpisode(const QString& path, const int anime_id,
-                                   const int episode_number) {
-  QDirIterator it{path, QDir::Files, QDirIterator::Subdirectories};
+namespace {
+
+std::string_view directoryName(std::string_view path) {
+  const auto pos = path.find_last_of('/');
+  return pos != std::string_view::npos ? path.substr(pos + 1) : path;
+}
+
+std::string joinPath(const FileEntry& entry) {
+  return std::format("{}/{}", entry.directory, entry.name);
+}
+
+}  // namespace
+
+Scanner::Scanner(std::shared_ptr<const recognition::Cache> cache) : cache_{std::move(cache)} {}
+
+const recognition::Cache& Scanner::cache() const {
+  return *cache_;
+}
+
+const Scanner::Folder& Scanner::scanDirectory(const FileEntry& entry) {
+  auto episode = recognition::parse(entry.name);
+
+  Folder folder{.title = recognition::normalize(episode.element(anitomy::ElementKind::Title))};
+
+  if (!folder.title.empty()) {
+    folder.anime_id = recognition::identify(*cache_, episode);
+    folder.is_identified = folder.anime_id != anime::kUnknownId;
+  }
+
+  if (!folder.is_identified) {
+    if (const auto parent = findParent(entry)) {
+      folder.anime_id = parent->anime_id;
+      folder.title = parent->title;
+    }
+  }
+
+  return folders_.insert_or_assign(joinPath(entry), std::move(folder)).first->second;
+}
 
-  while (it.hasNext()) {
-    const auto info = it.nextFileInfo();
+Episode Scanner::parseFile(const FileEntry& entry) const {
+  const auto folder = findParent(entry);
 
-    if (!info.isFile()) continue;
+  // Without a known folder, we fall back to using the folder name as title
+  if (!folder || folder->anime_id == anime::kUnknownId) {
+    return recognition::parseFile(entry.name, directoryName(entry.directory));
+  }
+
+  return recognition::parse(entry.name);
+}
+
+int Scanner::identifyFile(const FileEntry& entry, Episode& episode) const {
+  const auto folder = findParent(entry);
+
+  // Files in a known folder only need a consistency check: either their title
+  // is the same as the folder's, or it is one of the titles of the same anime.
+  if (folder && folder->anime_id != anime::kUnknownId) {
+    const auto title = recognition::normalize(episode.element(anitomy::ElementKind::Title));
+    const bool is_consistent = title.empty() || title == folder->title ||
+                               cache_->contains(title, folder->anime_id);
+    if (is_consistent && recognition::isValidMatch(*cache_, folder->anime_id, episode)) {
+      return folder->anime_id;
+    }
+  }
+
+  return recognition::identify(*cache_, episode);
+}
+
+const Scanner::Folder* Scanner::findParent(const FileEntry& entry) const {
+  const auto it = folders_.find(entry.directory);
+  return it != folders_.end() ? &it->second : nullptr;
+}
 
-    auto episode = recognition::parseFileInfo(info);
+////////////////////////////////////////////////////////////////////////////////
+
+std::optional<QString> findEpisode(const QString& path, const int anime_id,
+                                   const int episode_number) {
+  Scanner scanner{recognition::cache()};
+  std::optional<QString> result;
+
+  createFileWalker()->walk(path.toStdString(), {}, [&](const FileEntry& entry) {
+    // Folders of another anime are not skipped, because they may contain one of
+    // the target (e.g. "Nisemonogatari" in a "Monogatari" folder).
+    if (entry.is_directory) {
+      scanner.scanDirectory(entry);
+      return WalkResult::Continue;
+    }
+
+    auto episode = scanner.parseFile(entry);
 
     if (QString::fromStdString(episode.element(anitomy::ElementKind::Episode)).toInt() !=
         episode_number) {
-      continue;
+      return WalkResult::Continue;
     }
 
-    if (track::recognition::identify(episode) != anime_id) continue;
+    if (scanner.identifyFile(entry, episode) != anime_id) return WalkResult::Continue;
 
-    return info.filePath();
-  }
+    result = QString::fromStdString(joinPath(entry));
+    return WalkResult::Stop;
+  });
 
-  return std::nullopt;
+  return result;
 }
 
 std::optional<QString> findFolder(const QString& path, const int anime_id) {
-  QDirIterator it{path, QDir::Dirs, QDirIterator::Subdirectories};
-
-  while (it.hasNext()) {
-    const auto info = it.nextFileInfo();
+  Scanner scanner{recognition::cache()};
+  std::optional<QString> result;
 
-    if (!info.isDir()) continue;
+  createFileWalker()->walk(path.toStdString(), {}, [&](const FileEntry& entry) {
+    if (!entry.is_directory) return WalkResult::Continue;
 
-    auto episode = recognition::parseFileInfo(info);
+    const auto& folder = scanner.scanDirectory(entry);
 
-    if (track::recognition::identify(episode) != anime_id) continue;
+    if (folder.is_identified && folder.anime_id == anime_id) {
+      result = QString::fromStdString(joinPath(entry));
+      return WalkResult::Stop;
+    }
 
-    return info.filePath();
-  }
+    // Folders of another anime may contain one of the target, e.g. a franchise
+    // folder that was identified as its first entry.
+    return WalkResult::Continue;
+  });
 
-  return std::nullopt;
+  return result;
 }
 
 }  // namespace track
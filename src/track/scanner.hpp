@@ -19,10 +19,56 @@
 #pragma once
 
 #include <QString>
+#include <functional>
+#include <memory>
 #include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
 
 namespace track {
 
+class Episode;
+struct FileEntry;
+
+namespace recognition {
+class Cache;
+}
+
+// Identifies each directory once, and lets files inherit the anime that their
+// folder belongs to. Folders that cannot be identified by their own name (e.g.
+// "Season 1") inherit the anime of their parent folder.
+class Scanner final {
+public:
+  struct Folder {
+    int anime_id = 0;
+    bool is_identified = false;  // identified by its own name, rather than inherited
+    std::string title;           // normalized
+  };
+
+  explicit Scanner(std::shared_ptr<const recognition::Cache> cache);
+
+  const recognition::Cache& cache() const;
+
+  const Folder& scanDirectory(const FileEntry& entry);
+
+  Episode parseFile(const FileEntry& entry) const;
+  int identifyFile(const FileEntry& entry, Episode& episode) const;
+
+private:
+  struct Hash {
+    using is_transparent = void;
+    size_t operator()(std::string_view str) const {
+      return std::hash<std::string_view>{}(str);
+    }
+  };
+
+  const Folder* findParent(const FileEntry& entry) const;
+
+  std::shared_ptr<const recognition::Cache> cache_;
+  std::unordered_map<std::string, Folder, Hash, std::equal_to<>> folders_;
+};
+
 std::optional<QString> findEpisode(const QString& path, const int anime_id,
                                    const int episode_number);
 std::optional<QString> findFolder(const QString& path, const int anime_id);